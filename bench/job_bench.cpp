@@ -0,0 +1,96 @@
+#include <job_bench.hpp>
+#include <job_system.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <print>
+#include <thread>
+#include <vector>
+
+namespace lvk {
+namespace {
+using Clock = std::chrono::steady_clock;
+
+struct Round {
+	Clock::duration duration{Clock::duration::max()};
+	std::size_t stolen{};
+};
+
+// runs round() info.rounds times, returns the fastest.
+template <typename Func>
+[[nodiscard]] auto best_of(JobBenchInfo const& info, Func const& round)
+	-> Round {
+	auto ret = Round{};
+	for (std::size_t i = 0; i < info.rounds; ++i) {
+		auto const result = round();
+		if (result.duration < ret.duration) { ret = result; }
+	}
+	return ret;
+}
+
+void print_round(char const* name, std::size_t const job_count,
+				 Round const& round) {
+	auto const ms =
+		std::chrono::duration<double, std::milli>(round.duration).count();
+	auto const mjobs_per_s = double(job_count) / ms / 1000.0;
+	std::println("[lvk] Jobs {}: {} in {:.3f}ms ({:.2f} M jobs/s), stolen: {}",
+				 name, job_count, ms, mjobs_per_s, round.stolen);
+}
+} // namespace
+
+void run_job_bench(JobBenchInfo const& info) {
+	auto jobs = JobSystem{info.worker_count};
+	std::println("[lvk] Job bench: {} workers, {} jobs, best of {} rounds",
+				 jobs.worker_count(), info.job_count, info.rounds);
+	auto handles = std::vector<JobHandle>{};
+	handles.reserve(info.job_count);
+
+	auto const submit = best_of(info, [&] {
+		handles.clear();
+		auto const caller = std::this_thread::get_id();
+		auto stolen = std::atomic<std::size_t>{};
+		auto const task = [&] {
+			if (std::this_thread::get_id() != caller) { ++stolen; }
+		};
+		auto const start = Clock::now();
+		for (std::size_t i = 0; i < info.job_count; ++i) {
+			handles.push_back(jobs.submit(task));
+		}
+		for (auto const& handle : handles) { jobs.wait(handle); }
+		return Round{.duration = Clock::now() - start, .stolen = stolen};
+	});
+	print_round("submit", info.job_count, submit);
+
+	auto const fan_out = best_of(info, [&] {
+		handles.clear();
+		auto stolen = std::atomic<std::size_t>{};
+		auto const start = Clock::now();
+		// without workers this runs on the waiting thread, like any job.
+		auto const root = jobs.submit([&] {
+			auto const owner = std::this_thread::get_id();
+			auto const task = [&] {
+				if (std::this_thread::get_id() != owner) { ++stolen; }
+			};
+			for (std::size_t i = 0; i < info.job_count; ++i) {
+				handles.push_back(jobs.submit(task));
+			}
+			for (auto const& handle : handles) { jobs.wait(handle); }
+		});
+		jobs.wait(root);
+		return Round{.duration = Clock::now() - start, .stolen = stolen};
+	});
+	print_round("fan-out", info.job_count, fan_out);
+
+	auto const parallel_for = best_of(info, [&] {
+		auto const caller = std::this_thread::get_id();
+		auto stolen = std::atomic<std::size_t>{};
+		auto const func = [&](std::size_t const begin, std::size_t const end) {
+			if (std::this_thread::get_id() != caller) { stolen += end - begin; }
+		};
+		auto const start = Clock::now();
+		jobs.parallel_for(info.job_count, 1, func);
+		return Round{.duration = Clock::now() - start, .stolen = stolen};
+	});
+	print_round("parallel_for", info.job_count, parallel_for);
+}
+} // namespace lvk
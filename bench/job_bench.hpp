@@ -0,0 +1,20 @@
+#pragma once
+#include <cstddef>
+
+namespace lvk {
+struct JobBenchInfo {
+	std::size_t worker_count{};
+	// empty jobs per case and round.
+	std::size_t job_count{100000};
+	// the fastest round of each case is reported.
+	std::size_t rounds{5};
+};
+
+// Measures JobSystem scheduling overhead with empty jobs, and prints one
+// line per case:
+// - submit: jobs submitted from this (non-worker) thread, then waited on.
+// - fan-out: jobs submitted by a job into its worker's own queue, which the
+//   other workers steal from.
+// - parallel_for: chunks of one element each.
+void run_job_bench(JobBenchInfo const& info);
+} // namespace lvk
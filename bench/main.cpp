@@ -0,0 +1,76 @@
+#include <job_bench.hpp>
+#include <transform_bench.hpp>
+#include <charconv>
+#include <cstdlib>
+#include <exception>
+#include <format>
+#include <print>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+
+namespace {
+// parses the argument following a flag, throws if missing or invalid.
+template <typename Type>
+auto parse_value(std::span<char*>& args) -> Type {
+	auto const flag = std::string_view{args.front()};
+	if (args.size() < 2) {
+		throw std::runtime_error{std::format("Missing value for '{}'", flag)};
+	}
+	args = args.subspan(1);
+	auto const value = std::string_view{args.front()};
+	auto ret = Type{};
+	auto const [ptr, ec] =
+		std::from_chars(value.data(), value.data() + value.size(), ret);
+	if (ec != std::errc{} || ptr != value.data() + value.size()) {
+		throw std::runtime_error{
+			std::format("Invalid value for '{}': '{}'", flag, value)};
+	}
+	return ret;
+}
+} // namespace
+
+// microbenchmarks, kept out of the app: each flag runs one of them.
+auto main(int argc, char** argv) -> int {
+	try {
+		auto worker_count = std::size_t{};
+		auto job_count = std::size_t{};
+		auto transform_count = std::size_t{};
+		// skip the first argument.
+		auto args = std::span{argv, static_cast<std::size_t>(argc)}.subspan(1);
+		while (!args.empty()) {
+			auto const arg = std::string_view{args.front()};
+			if (arg == "--workers") {
+				worker_count = parse_value<std::size_t>(args);
+			} else if (arg == "--jobs") {
+				job_count = parse_value<std::size_t>(args);
+			} else if (arg == "--transforms") {
+				transform_count = parse_value<std::size_t>(args);
+			} else {
+				throw std::runtime_error{
+					std::format("Unknown argument: '{}'", arg)};
+			}
+			args = args.subspan(1);
+		}
+		if (job_count == 0 && transform_count == 0) {
+			std::println("Usage: {} [--workers <count>] [--jobs <count>] "
+						 "[--transforms <count>]",
+						 argv[0]);
+			return EXIT_FAILURE;
+		}
+		if (job_count > 0) {
+			lvk::run_job_bench(lvk::JobBenchInfo{
+				.worker_count = worker_count,
+				.job_count = job_count,
+			});
+		}
+		if (transform_count > 0) {
+			lvk::run_transform_bench(lvk::TransformBenchInfo{
+				.transform_count = transform_count,
+			});
+		}
+	} catch (std::exception const& e) {
+		std::println(stderr, "PANIC: {}", e.what());
+		return EXIT_FAILURE;
+	}
+}
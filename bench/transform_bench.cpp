@@ -0,0 +1,138 @@
+#include <transform_bench.hpp>
+#include <transform_batch.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <format>
+#include <numbers>
+#include <print>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace lvk {
+namespace {
+using Clock = std::chrono::steady_clock;
+
+// relative to the largest of 1 and the scale of the checked column.
+constexpr auto max_error_v = 4e-6;
+
+[[nodiscard]] auto to_ms(Clock::duration const duration) -> double {
+	return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+// largest error of matrices against transforms [0, matrices.size()).
+[[nodiscard]] auto get_max_error(TransformBatch const& batch,
+								 std::span<glm::mat4 const> matrices)
+	-> double {
+	static constexpr auto deg_to_rad_v = std::numbers::pi / 180.0;
+	auto ret = 0.0;
+	for (std::size_t i = 0; i < matrices.size(); ++i) {
+		auto const transform = batch.get(i);
+		auto const radians = double(transform.rotation) * deg_to_rad_v;
+		auto const c = std::cos(radians);
+		auto const s = std::sin(radians);
+		auto const sx = double(transform.scale.x);
+		auto const sy = double(transform.scale.y);
+		// column-major, like glm::mat4.
+		auto const expected = std::array<std::array<double, 4>, 4>{{
+			{c * sx, s * sx, 0.0, 0.0},
+			{-s * sy, c * sy, 0.0, 0.0},
+			{0.0, 0.0, 1.0, 0.0},
+			{transform.position.x, transform.position.y, 0.0, 1.0},
+		}};
+		auto const magnitudes =
+			std::array{std::max(1.0, std::abs(sx)),
+					   std::max(1.0, std::abs(sy)), 1.0, 1.0};
+		for (std::size_t col = 0; col < 4; ++col) {
+			auto const& column = matrices[i][glm::length_t(col)];
+			for (std::size_t row = 0; row < 4; ++row) {
+				auto const actual = double(column[glm::length_t(row)]);
+				auto const error = std::abs(actual - expected.at(col).at(row));
+				ret = std::max(ret, error / magnitudes.at(col));
+			}
+		}
+	}
+	return ret;
+}
+
+void check_error(char const* name, double const error) {
+	std::println("[lvk] Transforms {}: max error {:.3e}", name, error);
+	if (error > max_error_v) {
+		throw std::runtime_error{std::format(
+			"Transform {} error {:.3e} exceeds {:.3e}", name, error,
+			max_error_v)};
+	}
+}
+
+// runs round() info.rounds times, returns the fastest.
+template <typename Func>
+[[nodiscard]] auto best_of(TransformBenchInfo const& info, Func const& round)
+	-> Clock::duration {
+	auto ret = Clock::duration::max();
+	for (std::size_t i = 0; i < info.rounds; ++i) {
+		auto const start = Clock::now();
+		round();
+		ret = std::min(ret, Clock::now() - start);
+	}
+	return ret;
+}
+
+void print_rate(char const* name, std::size_t const count,
+				Clock::duration const duration) {
+	auto const ms = to_ms(duration);
+	std::println("[lvk] Transforms {}: {} in {:.3f}ms ({:.2f} M/s)", name,
+				 count, ms, double(count) / ms / 1000.0);
+}
+} // namespace
+
+void run_transform_bench(TransformBenchInfo const& info) {
+	std::println("[lvk] Transform bench: {} transforms, best of {} rounds",
+				 info.transform_count, info.rounds);
+
+	// full turns in both directions, unit scale: the 2x2 block is sin/cos.
+	static constexpr std::size_t angle_count_v{144001};
+	auto batch = TransformBatch{};
+	batch.resize(angle_count_v);
+	for (std::size_t i = 0; i < angle_count_v; ++i) {
+		auto const degrees = -720.0f + 0.01f * float(i);
+		batch.set(i, Transform{.rotation = degrees});
+	}
+	auto matrices = std::vector<glm::mat4>(angle_count_v);
+	batch.write_model_matrices(0, matrices);
+	check_error("sin_cos", get_max_error(batch, matrices));
+
+	auto random = std::mt19937{42};
+	auto position = std::uniform_real_distribution<float>{-1000.0f, 1000.0f};
+	auto rotation = std::uniform_real_distribution<float>{-720.0f, 720.0f};
+	auto scale = std::uniform_real_distribution<float>{-10.0f, 10.0f};
+	batch.resize(info.transform_count);
+	for (std::size_t i = 0; i < info.transform_count; ++i) {
+		batch.set(i, Transform{
+						 .position = {position(random), position(random)},
+						 .rotation = rotation(random),
+						 .scale = {scale(random), scale(random)},
+					 });
+	}
+	matrices.resize(info.transform_count);
+	// batched: SIMD lanes, and the scalar tail if count is not a multiple.
+	batch.write_model_matrices(0, matrices);
+	check_error("batched", get_max_error(batch, matrices));
+	// one at a time: only the scalar path.
+	for (std::size_t i = 0; i < info.transform_count; ++i) {
+		batch.write_model_matrices(i, std::span{matrices}.subspan(i, 1));
+	}
+	check_error("scalar", get_max_error(batch, matrices));
+
+	auto const matrix_time = best_of(
+		info, [&] { batch.write_model_matrices(0, std::span{matrices}); });
+	print_rate("matrices", info.transform_count, matrix_time);
+
+	auto packed = std::vector<PackedInstance>(info.transform_count);
+	auto const packed_time = best_of(
+		info, [&] { batch.write_packed_instances(0, std::span{packed}); });
+	print_rate("packed", info.transform_count, packed_time);
+}
+} // namespace lvk
@@ -0,0 +1,15 @@
+#pragma once
+#include <cstddef>
+
+namespace lvk {
+struct TransformBenchInfo {
+	std::size_t transform_count{1000000};
+	// the fastest round of each case is reported.
+	std::size_t rounds{5};
+};
+
+// Checks TransformBatch's model matrices (SIMD lanes and the scalar tail)
+// against a double precision reference, then measures how fast matrices and
+// packed instances are written. Throws if a kernel exceeds the error bound.
+void run_transform_bench(TransformBenchInfo const& info);
+} // namespace lvk
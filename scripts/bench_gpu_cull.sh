@@ -0,0 +1,20 @@
+#!/bin/bash
+
+# Compares frame times with and without GPU culling, with most instances off-screen.
+# Usage: scripts/bench_gpu_cull.sh <path/to/learn-vk> [instances] [frames]
+# Requires the culling shader variants (scripts/compile_shaders.sh).
+
+exe=$1
+instances=${2:-1000000}
+frames=${3:-500}
+
+[[ ! -x "$exe" ]] && { echo "Usage: $0 <path/to/learn-vk> [instances] [frames]"; exit 1; }
+
+[[ ! -d ./assets ]] && { echo "Please run script from the project root"; exit 1; }
+
+for flag in "" "--gpu-cull"; do
+	echo "-- culling: ${flag:-off}"
+	"$exe" --headless --frames "$frames" --instances "$instances" $flag | grep "Headless:\|GPU Scene" || exit 1
+done
+
+exit
@@ -0,0 +1,20 @@
+#!/bin/bash
+
+# Compares frame times of matrix and packed instance formats.
+# Usage: scripts/bench_instance_format.sh <path/to/learn-vk> [instances] [frames]
+# Requires assets/shader_packed.vert (scripts/compile_shaders.sh).
+
+exe=$1
+instances=${2:-1000000}
+frames=${3:-500}
+
+[[ ! -x "$exe" ]] && { echo "Usage: $0 <path/to/learn-vk> [instances] [frames]"; exit 1; }
+
+[[ ! -d ./assets ]] && { echo "Please run script from the project root"; exit 1; }
+
+for format in "" "--packed-instances"; do
+	echo "-- instance format: ${format:-matrix}"
+	"$exe" --headless --frames "$frames" --instances "$instances" $format | grep "Headless:\|GPU Scene" || exit 1
+done
+
+exit
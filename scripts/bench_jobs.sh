@@ -0,0 +1,16 @@
+#!/bin/bash
+
+# Measures JobSystem submit, steal and parallel_for throughput against the number of workers.
+# Usage: scripts/bench_jobs.sh <path/to/learn-vk-bench> [jobs]
+
+exe=$1
+jobs=${2:-100000}
+
+[[ ! -x "$exe" ]] && { echo "Usage: $0 <path/to/learn-vk-bench> [jobs]"; exit 1; }
+
+for workers in 0 1 2 4 8 $(nproc); do
+	echo "-- workers: $workers"
+	"$exe" --workers "$workers" --jobs "$jobs" | grep "Jobs" || exit 1
+done
+
+exit
@@ -0,0 +1,19 @@
+#!/bin/bash
+
+# Measures CPU draw recording time against the number of recording threads.
+# Usage: scripts/bench_record_threads.sh <path/to/learn-vk> [draws] [frames]
+
+exe=$1
+draws=${2:-20000}
+frames=${3:-500}
+
+[[ ! -x "$exe" ]] && { echo "Usage: $0 <path/to/learn-vk> [draws] [frames]"; exit 1; }
+
+[[ ! -d ./assets ]] && { echo "Please run script from the project root"; exit 1; }
+
+for threads in 0 1 2 4 8 $(nproc); do
+	echo "-- record threads: $threads"
+	"$exe" --headless --frames "$frames" --draws "$draws" --record-threads "$threads" | grep "CPU draw" || exit 1
+done
+
+exit
@@ -0,0 +1,13 @@
+#!/bin/bash
+
+# Checks the SIMD transform kernels against a double precision reference and measures their throughput.
+# Usage: scripts/bench_transforms.sh <path/to/learn-vk-bench> [transforms]
+
+exe=$1
+transforms=${2:-1000000}
+
+[[ ! -x "$exe" ]] && { echo "Usage: $0 <path/to/learn-vk-bench> [transforms]"; exit 1; }
+
+"$exe" --transforms "$transforms" | grep "Transforms" || exit 1
+
+exit
@@ -0,0 +1,24 @@
+#!/bin/bash
+
+# Compiles all GLSL sources and variants in src/glsl to SPIR-V in assets.
+# Requires glslc (part of the Vulkan SDK).
+
+[[ ! -d ./assets ]] && { echo "Please run script from the project root"; exit 1; }
+
+glslc="${GLSLC:-glslc}"
+
+compile() {
+	echo "-- $1 => assets/$2"
+	"$glslc" "${@:3}" "src/glsl/$1" -o "assets/$2" || exit 1
+}
+
+compile shader.vert shader.vert
+compile shader.frag shader.frag
+compile shader.frag shader_bindless.frag -DBINDLESS
+compile shader_packed.vert shader_packed.vert
+compile shader.vert shader_culled.vert -DCULLED
+compile shader_packed.vert shader_packed_culled.vert -DCULLED
+compile cull.comp cull.comp
+compile cull.comp cull_packed.comp -DPACKED_INSTANCES
+
+exit
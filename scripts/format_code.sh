@@ -4,7 +4,7 @@
 
 [[ ! -d ./src ]] && (echo "Please run script from the project root"; exit 1)
 
-files=$(find src -name "*.?pp")
+files=$(find src bench -name "*.?pp")
 
 [[ "$files" == "" ]] && (echo "-- No source files found"; exit)
 
@@ -1,9 +1,11 @@
 #include <app.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <trace.hpp>
 #include <vertex.hpp>
 #include <bit>
 #include <cassert>
 #include <chrono>
+#include <cmath>
 #include <fstream>
 #include <print>
 #include <ranges>
@@ -14,15 +16,42 @@ namespace lvk {
 using namespace std::chrono_literals;
 
 namespace {
-template <typename T>
-[[nodiscard]] constexpr auto to_byte_array(T const& t) {
-	return std::bit_cast<std::array<std::byte, sizeof(T)>>(t);
+// one timestamp at the start of the frame, and one at the end of each pass.
+constexpr auto timestamp_count_v =
+	static_cast<std::uint32_t>(PassTimings::pass_count_v + 1);
+
+// half size of the bounds of every mesh, in model space.
+constexpr auto mesh_extent_v = 200.0f;
+
+// regular polygon inscribed in the mesh bounds, as a triangle fan.
+[[nodiscard]] auto make_polygon(std::uint32_t const sides)
+	-> std::pair<std::vector<Vertex>, std::vector<std::uint32_t>> {
+	auto ret = std::pair<std::vector<Vertex>, std::vector<std::uint32_t>>{};
+	auto& [vertices, indices] = ret;
+	// map positions to UVs the same way as the quad: +Y is up, V is down.
+	auto const to_uv = [](glm::vec2 const position) {
+		auto const uv = position / (2.0f * mesh_extent_v);
+		return glm::vec2{uv.x + 0.5f, 0.5f - uv.y};
+	};
+	vertices.push_back(Vertex{.uv = to_uv({})});
+	for (std::uint32_t i = 0; i < sides; ++i) {
+		// first vertex points up.
+		auto const angle = glm::radians(90.0f + 360.0f * static_cast<float>(i) /
+												   static_cast<float>(sides));
+		auto const position =
+			mesh_extent_v * glm::vec2{std::cos(angle), std::sin(angle)};
+		vertices.push_back(Vertex{.position = position, .uv = to_uv(position)});
+		indices.insert(indices.end(), {0u, 1u + i, 1u + ((i + 1) % sides)});
+	}
+	return ret;
 }
 
 constexpr auto layout_binding(std::uint32_t binding,
 							  vk::DescriptorType const type) {
 	return vk::DescriptorSetLayoutBinding{
-		binding, type, 1, vk::ShaderStageFlagBits::eAllGraphics};
+		binding, type, 1,
+		vk::ShaderStageFlagBits::eAllGraphics |
+			vk::ShaderStageFlagBits::eCompute};
 }
 
 [[nodiscard]] auto locate_assets_dir() -> fs::path {
@@ -38,6 +67,15 @@ constexpr auto layout_binding(std::uint32_t binding,
 	return fs::current_path();
 }
 
+// shader variants are not committed: the build or
+// scripts/compile_shaders.sh compiles them from src/glsl.
+[[nodiscard]] auto has_shader(fs::path const& path) -> bool {
+	if (fs::exists(path)) { return true; }
+	std::println("[lvk] Missing shader '{}': run scripts/compile_shaders.sh",
+				 path.generic_string());
+	return false;
+}
+
 [[nodiscard]] auto get_layers(std::span<char const* const> desired)
 	-> std::vector<char const*> {
 	auto ret = std::vector<char const*>{};
@@ -57,6 +95,22 @@ constexpr auto layout_binding(std::uint32_t binding,
 	return ret;
 }
 
+// sorts ranges and merges overlapping or adjacent ones.
+void coalesce(std::vector<TransformBatch::Range>& ranges) {
+	if (ranges.size() < 2) { return; }
+	std::ranges::sort(ranges, {}, &TransformBatch::Range::first);
+	auto out = ranges.begin();
+	for (auto it = std::next(ranges.begin()); it != ranges.end(); ++it) {
+		auto const end = out->first + out->count;
+		if (it->first <= end) {
+			out->count = std::max(end, it->first + it->count) - out->first;
+		} else {
+			*++out = *it;
+		}
+	}
+	ranges.erase(std::next(out), ranges.end());
+}
+
 [[nodiscard]] auto to_spir_v(fs::path const& path)
 	-> std::vector<std::uint32_t> {
 	// open the file at the end, to get the total size.
@@ -84,33 +138,110 @@ constexpr auto layout_binding(std::uint32_t binding,
 } // namespace
 
 void App::run() {
+	if (!m_options.trace_json.empty()) {
+		trace::set_enabled(true);
+		trace::set_thread_name("main");
+	}
+
+	if (m_options.frames_in_flight == 0 ||
+		m_options.frames_in_flight > max_resource_buffering_v) {
+		throw std::runtime_error{
+			std::format("Frames in flight must be in [1, {}]",
+						max_resource_buffering_v)};
+	}
+	if (m_options.headless && m_options.frame_count == 0) {
+		// the report divides by it.
+		throw std::runtime_error{"Headless frame count must be at least 1"};
+	}
+	std::println("[lvk] Frames in flight: {}", m_options.frames_in_flight);
+
 	m_assets_dir = locate_assets_dir();
+	if (m_options.bindless &&
+		!has_shader(asset_path("shader_bindless.frag"))) {
+		std::println("[lvk] Bindless textures: disabled");
+		m_options.bindless = false;
+	}
+	if (m_options.bindless &&
+		m_options.instance_format != InstanceFormat::Packed) {
+		// only packed instances carry a texture table slot.
+		std::println("[lvk] Bindless textures: using packed instances");
+		m_options.instance_format = InstanceFormat::Packed;
+	}
+	if (m_options.instance_format == InstanceFormat::Packed &&
+		!has_shader(asset_path("shader_packed.vert"))) {
+		std::println("[lvk] Packed instances: using matrices");
+		m_options.instance_format = InstanceFormat::Matrix;
+		m_options.bindless = false;
+	}
+	if (m_options.gpu_culling) {
+		auto const packed = m_options.instance_format == InstanceFormat::Packed;
+		auto const vertex =
+			packed ? "shader_packed_culled.vert" : "shader_culled.vert";
+		auto const cull = packed ? "cull_packed.comp" : "cull.comp";
+		if (!has_shader(asset_path(vertex)) || !has_shader(asset_path(cull))) {
+			std::println("[lvk] GPU culling: disabled");
+			m_options.gpu_culling = false;
+		}
+	}
 
-	create_window();
+	create_job_system();
+	if (!m_options.headless) { create_window(); }
 	create_instance();
-	create_surface();
+	if (!m_options.headless) { create_surface(); }
 	select_gpu();
 	create_device();
 	create_allocator();
-	create_swapchain();
+	if (m_options.headless) {
+		create_offscreen();
+	} else {
+		create_swapchain();
+	}
 	create_render_sync();
+	if (m_options.record_threads > 0) { create_secondary_recorder(); }
 	create_imgui();
-	create_descriptor_pool();
+	create_texture_table();
+	create_descriptor_allocator();
 	create_pipeline_layout();
-	create_shader();
+	// shader creation (file IO and driver compilation) only needs the
+	// device and set layouts: overlap it with resource uploads.
+	// the job writes members: wait for it on every exit path.
+	auto shader_job = ScopedJobs{*m_job_system};
+	shader_job.add(m_job_system->submit([this] { create_shader(); }));
 	create_cmd_block_pool();
+	create_staging_ring();
 
 	create_shader_resources();
 	create_descriptor_sets();
+	shader_job.wait();
+
+	if (m_options.headless) {
+		headless_loop();
+	} else {
+		main_loop();
+	}
+
+	if (!m_options.perf_csv.empty()) {
+		m_pass_timings.write_csv(m_options.perf_csv);
+	}
+	if (!m_options.trace_json.empty()) {
+		trace::set_enabled(false);
+		trace::write_json(m_options.trace_json);
+	}
+}
 
-	main_loop();
+void App::create_job_system() {
+	auto const zone = trace::Zone{"create_job_system"};
+	m_job_system.emplace(m_options.worker_threads);
+	std::println("[lvk] Job system workers: {}", m_options.worker_threads);
 }
 
 void App::create_window() {
+	auto const zone = trace::Zone{"create_window"};
 	m_window = glfw::create_window({1280, 720}, "Learn Vulkan");
 }
 
 void App::create_instance() {
+	auto const zone = trace::Zone{"create_instance"};
 	// initialize the dispatcher without any arguments.
 	VULKAN_HPP_DEFAULT_DISPATCHER.init();
 	auto const loader_version = vk::enumerateInstanceVersion();
@@ -123,7 +254,10 @@ void App::create_instance() {
 
 	auto instance_ci = vk::InstanceCreateInfo{};
 	// need WSI instance extensions here (platform-specific Swapchains).
-	auto const extensions = glfw::instance_extensions();
+	// headless rendering does not present, and GLFW is not initialized.
+	auto const extensions = m_options.headless
+								? std::span<char const* const>{}
+								: glfw::instance_extensions();
 	instance_ci.setPApplicationInfo(&app_info).setPEnabledExtensionNames(
 		extensions);
 
@@ -140,22 +274,37 @@ void App::create_instance() {
 }
 
 void App::create_surface() {
+	auto const zone = trace::Zone{"create_surface"};
 	m_surface = glfw::create_surface(m_window.get(), *m_instance);
 }
 
 void App::select_gpu() {
+	auto const zone = trace::Zone{"select_gpu"};
 	m_gpu = get_suitable_gpu(*m_instance, *m_surface);
 	std::println("[lvk] Using GPU: {}",
 				 std::string_view{m_gpu.properties.deviceName});
 }
 
 void App::create_device() {
-	auto queue_ci = vk::DeviceQueueCreateInfo{};
-	// since we use only one queue, it has the entire priority range, ie, 1.0
+	auto const zone = trace::Zone{"create_device"};
+	auto queue_cis = std::array<vk::DeviceQueueCreateInfo, 2>{};
+	// since we use only one queue per family, it has the entire priority
+	// range, ie, 1.0
 	static constexpr auto queue_priorities_v = std::array{1.0f};
-	queue_ci.setQueueFamilyIndex(m_gpu.queue_family)
+	queue_cis[0]
+		.setQueueFamilyIndex(m_gpu.queue_family)
 		.setQueueCount(1)
 		.setQueuePriorities(queue_priorities_v);
+	// uploads run on a separate transfer queue, if requested and available.
+	auto const use_transfer_queue =
+		m_options.transfer_queue && m_gpu.transfer_queue_family.has_value();
+	if (use_transfer_queue) {
+		queue_cis[1]
+			.setQueueFamilyIndex(*m_gpu.transfer_queue_family)
+			.setQueueCount(1)
+			.setQueuePriorities(queue_priorities_v);
+	}
+	auto const queue_count = use_transfer_queue ? 2u : 1u;
 
 	// nice-to-have optional core features, enable if GPU supports them.
 	auto enabled_features = vk::PhysicalDeviceFeatures{};
@@ -163,6 +312,13 @@ void App::create_device() {
 	enabled_features.wideLines = m_gpu.features.wideLines;
 	enabled_features.samplerAnisotropy = m_gpu.features.samplerAnisotropy;
 	enabled_features.sampleRateShading = m_gpu.features.sampleRateShading;
+	enabled_features.multiDrawIndirect = m_gpu.features.multiDrawIndirect;
+	// block compressed textures are uploaded as they are if supported.
+	enabled_features.textureCompressionBC = m_gpu.features.textureCompressionBC;
+	enabled_features.textureCompressionETC2 =
+		m_gpu.features.textureCompressionETC2;
+	enabled_features.textureCompressionASTC_LDR =
+		m_gpu.features.textureCompressionASTC_LDR;
 
 	// extra features that need to be explicitly enabled.
 	auto sync_feature = vk::PhysicalDeviceSynchronization2Features{vk::True};
@@ -175,15 +331,72 @@ void App::create_device() {
 	auto shader_object_feature =
 		vk::PhysicalDeviceShaderObjectFeaturesEXT{vk::True};
 	dynamic_rendering_feature.setPNext(&shader_object_feature);
+	// core since Vulkan 1.2, but still needs to be enabled.
+	auto timeline_feature =
+		vk::PhysicalDeviceTimelineSemaphoreFeatures{vk::True};
+	shader_object_feature.setPNext(&timeline_feature);
+	// optional features are appended to the end of the chain.
+	void** chain_end = &timeline_feature.pNext;
+	auto const append_feature = [&chain_end](auto& feature) {
+		*chain_end = &feature;
+		chain_end = &feature.pNext;
+	};
+
+	// optional: descriptor buffer, which replaces push descriptors, dynamic
+	// descriptors and the bindless table (all need descriptor sets).
+	m_descriptor_buffer =
+		m_options.descriptor_buffer && m_gpu.descriptor_buffer.has_value();
+	if (m_options.descriptor_buffer && !m_descriptor_buffer) {
+		std::println("[lvk] Descriptor buffer: not supported by GPU");
+	}
+	if (m_descriptor_buffer && m_options.dynamic_descriptors) {
+		std::println("[lvk] Descriptor buffer: disabling dynamic descriptors");
+		m_options.dynamic_descriptors = false;
+	}
+	auto address_feature =
+		vk::PhysicalDeviceBufferDeviceAddressFeatures{vk::True};
+	auto descriptor_buffer_feature =
+		vk::PhysicalDeviceDescriptorBufferFeaturesEXT{vk::True};
+	if (m_descriptor_buffer) {
+		append_feature(address_feature);
+		append_feature(descriptor_buffer_feature);
+	}
+
+	// optional: bindless textures.
+	m_bindless = m_options.bindless && !m_descriptor_buffer &&
+				 m_gpu.max_bindless_textures > 0;
+	auto indexing_feature = vk::PhysicalDeviceDescriptorIndexingFeatures{};
+	indexing_feature.setRuntimeDescriptorArray(vk::True)
+		.setDescriptorBindingPartiallyBound(vk::True)
+		.setDescriptorBindingSampledImageUpdateAfterBind(vk::True)
+		.setShaderSampledImageArrayNonUniformIndexing(vk::True);
+	if (m_bindless) { append_feature(indexing_feature); }
 
 	auto device_ci = vk::DeviceCreateInfo{};
 	// we need two device extensions: Swapchain and Shader Object.
 	static constexpr auto extensions_v = std::array{
-		VK_KHR_SWAPCHAIN_EXTENSION_NAME,
 		"VK_EXT_shader_object",
+		VK_KHR_SWAPCHAIN_EXTENSION_NAME,
 	};
-	device_ci.setPEnabledExtensionNames(extensions_v)
-		.setQueueCreateInfos(queue_ci)
+	// headless rendering does not need the Swapchain extension.
+	auto extensions = std::vector<char const*>{extensions_v.begin(),
+											   extensions_v.end()};
+	if (m_options.headless) { extensions.resize(1); }
+	// optional: push descriptors.
+	m_push_descriptors = m_options.push_descriptors &&
+						 !m_options.dynamic_descriptors &&
+						 !m_descriptor_buffer && m_gpu.push_descriptors;
+	if (m_push_descriptors) {
+		extensions.push_back(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME);
+	}
+	if (m_descriptor_buffer) {
+		extensions.push_back(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME);
+	}
+	std::println("[lvk] Push descriptors: {}, descriptor buffer: {}",
+				 m_push_descriptors, m_descriptor_buffer);
+	device_ci.setPEnabledExtensionNames(extensions)
+		.setQueueCreateInfoCount(queue_count)
+		.setPQueueCreateInfos(queue_cis.data())
 		.setPEnabledFeatures(&enabled_features)
 		.setPNext(&sync_feature);
 
@@ -192,16 +405,34 @@ void App::create_device() {
 	VULKAN_HPP_DEFAULT_DISPATCHER.init(*m_device);
 	static constexpr std::uint32_t queue_index_v{0};
 	m_queue = m_device->getQueue(m_gpu.queue_family, queue_index_v);
+	if (use_transfer_queue) {
+		m_transfer_queue =
+			m_device->getQueue(*m_gpu.transfer_queue_family, queue_index_v);
+	}
 
 	m_waiter = *m_device;
 }
 
 void App::create_swapchain() {
+	auto const zone = trace::Zone{"create_swapchain"};
 	auto const size = glfw::framebuffer_size(m_window.get());
 	m_swapchain.emplace(*m_device, m_gpu, *m_surface, size);
 }
 
+void App::create_offscreen() {
+	auto const zone = trace::Zone{"create_offscreen"};
+	auto const offscreen_ci = Offscreen::CreateInfo{
+		.device = *m_device,
+		.allocator = m_allocator.get(),
+		.queue_family = m_gpu.queue_family,
+		.size = m_options.extent,
+		.buffering = m_options.frames_in_flight,
+	};
+	m_offscreen.emplace(offscreen_ci);
+}
+
 void App::create_render_sync() {
+	auto const zone = trace::Zone{"create_render_sync"};
 	// Command Buffers are 'allocated' from a Command Pool (which is 'created'
 	// like all other Vulkan objects so far). We can allocate all the buffers
 	// from a single pool here.
@@ -212,9 +443,16 @@ void App::create_render_sync() {
 		.setQueueFamilyIndex(m_gpu.queue_family);
 	m_render_cmd_pool = m_device->createCommandPoolUnique(command_pool_ci);
 
+	if (m_options.timeline_sync) {
+		// single timeline semaphore for all frame and upload submissions.
+		m_timeline.emplace(*m_device);
+	}
+
+	m_render_sync.resize(m_options.frames_in_flight);
 	auto command_buffer_ai = vk::CommandBufferAllocateInfo{};
 	command_buffer_ai.setCommandPool(*m_render_cmd_pool)
-		.setCommandBufferCount(static_cast<std::uint32_t>(resource_buffering_v))
+		.setCommandBufferCount(
+			static_cast<std::uint32_t>(m_render_sync.size()))
 		.setLevel(vk::CommandBufferLevel::ePrimary);
 	auto const command_buffers =
 		m_device->allocateCommandBuffers(command_buffer_ai);
@@ -225,16 +463,38 @@ void App::create_render_sync() {
 	// to wait for yet).
 	static constexpr auto fence_create_info_v =
 		vk::FenceCreateInfo{vk::FenceCreateFlagBits::eSignaled};
+
+	// timestamps are only meaningful if the queue family has valid bits.
+	auto const valid_bits = m_gpu.device.getQueueFamilyProperties()
+								.at(m_gpu.queue_family)
+								.timestampValidBits;
+	m_timestamp_period = m_gpu.properties.limits.timestampPeriod;
+	m_timestamp_mask = valid_bits >= 64 ? ~std::uint64_t{}
+										: (std::uint64_t{1} << valid_bits) - 1;
+	auto query_pool_ci = vk::QueryPoolCreateInfo{};
+	query_pool_ci.setQueryType(vk::QueryType::eTimestamp)
+		.setQueryCount(timestamp_count_v);
+
 	for (auto [sync, command_buffer] :
 		 std::views::zip(m_render_sync, command_buffers)) {
 		sync.command_buffer = command_buffer;
 		sync.draw = m_device->createSemaphoreUnique({});
-		sync.drawn = m_device->createFenceUnique(fence_create_info_v);
+		// a timeline value of 0 is already signaled, no fence needed.
+		if (!m_timeline) {
+			sync.drawn = m_device->createFenceUnique(fence_create_info_v);
+		}
+		if (valid_bits > 0) {
+			sync.timestamps = m_device->createQueryPoolUnique(query_pool_ci);
+		}
+	}
+	if (valid_bits == 0) {
+		std::println("[lvk] GPU timestamps not supported, profiling disabled");
 	}
 }
 
 void App::create_imgui() {
-	auto const imgui_ci = DearImGui::CreateInfo{
+	auto const zone = trace::Zone{"create_imgui"};
+	auto imgui_ci = DearImGui::CreateInfo{
 		.window = m_window.get(),
 		.api_version = vk_version_v,
 		.instance = *m_instance,
@@ -242,65 +502,206 @@ void App::create_imgui() {
 		.queue_family = m_gpu.queue_family,
 		.device = *m_device,
 		.queue = m_queue,
-		.color_format = m_swapchain->get_format(),
+		.frame_count = static_cast<std::uint32_t>(m_options.frames_in_flight),
+		.color_format = color_format(),
 		.samples = vk::SampleCountFlagBits::e1,
 	};
+	if (m_options.headless) {
+		auto const size = glm::vec2{m_options.extent};
+		imgui_ci.display_size = ImVec2{size.x, size.y};
+	}
 	m_imgui.emplace(imgui_ci);
 }
 
+void App::create_secondary_recorder() {
+	auto const zone = trace::Zone{"create_secondary_recorder"};
+	auto const recorder_ci = SecondaryRecorder::CreateInfo{
+		.device = *m_device,
+		.queue_family = m_gpu.queue_family,
+		.job_system = &*m_job_system,
+		.thread_count = m_options.record_threads,
+		.buffering = m_options.frames_in_flight,
+		.color_format = color_format(),
+	};
+	m_secondary_recorder.emplace(recorder_ci);
+	std::println("[lvk] Recording draws on {} threads",
+				 m_options.record_threads);
+}
+
 void App::create_allocator() {
-	m_allocator = vma::create_allocator(*m_instance, m_gpu.device, *m_device);
+	auto const zone = trace::Zone{"create_allocator"};
+	// descriptor buffers are bound (and point at buffers) by address.
+	m_allocator = vma::create_allocator(*m_instance, m_gpu.device, *m_device,
+										m_descriptor_buffer);
 }
 
-void App::create_descriptor_pool() {
-	static constexpr auto pool_sizes_v = std::array{
-		// 2 uniform buffers, can be more if desired.
-		vk::DescriptorPoolSize{vk::DescriptorType::eUniformBuffer, 2},
-		vk::DescriptorPoolSize{vk::DescriptorType::eCombinedImageSampler, 2},
+void App::create_texture_table() {
+	auto const zone = trace::Zone{"create_texture_table"};
+	m_samplers.emplace(*m_device);
+	if (!m_bindless) {
+		if (m_options.bindless) {
+			std::println("[lvk] Bindless textures: not supported by GPU");
+		}
+		return;
+	}
+	static constexpr std::uint32_t capacity_v{4096};
+	auto const table_ci = TextureTable::CreateInfo{
+		.device = *m_device,
+		.capacity = std::min(capacity_v, m_gpu.max_bindless_textures),
+	};
+	m_texture_table.emplace(table_ci);
+	std::println("[lvk] Bindless texture table: {} slots",
+				 m_texture_table->get_capacity());
+}
+
+void App::create_descriptor_allocator() {
+	auto const zone = trace::Zone{"create_descriptor_allocator"};
+	m_frame_descriptors.resize(m_options.frames_in_flight);
+	// descriptor buffer: no pools or sets.
+	if (m_descriptor_buffer) { return; }
+	// initial descriptors per set, pools adapt to the registered layouts
+	// once sets have been allocated.
+	static constexpr std::uint32_t sets_v{16};
+	auto const ratios = std::array{
+		vk::DescriptorPoolSize{get_view_ubo_type(), 1},
+		vk::DescriptorPoolSize{vk::DescriptorType::eCombinedImageSampler, 1},
+		// instances.
+		vk::DescriptorPoolSize{get_instance_ssbo_type(), 1},
+		// visible indices and indirect draw.
 		vk::DescriptorPoolSize{vk::DescriptorType::eStorageBuffer, 2},
 	};
-	auto pool_ci = vk::DescriptorPoolCreateInfo{};
-	// allow 16 sets to be allocated from this pool.
-	pool_ci.setPoolSizes(pool_sizes_v).setMaxSets(16);
-	m_descriptor_pool = m_device->createDescriptorPoolUnique(pool_ci);
+	// storage buffers are only in set 2, which is not allocated if pushed.
+	auto const used_ratios =
+		std::span{ratios}.first(m_push_descriptors ? 2uz : 4uz);
+	auto const allocator_ci = DescriptorAllocator::CreateInfo{
+		.device = *m_device,
+		.ratios = used_ratios,
+		.initial_sets = sets_v,
+	};
+	m_descriptor_allocator.emplace(allocator_ci);
+
+	// bindless: set 1 is the texture table, there are no transient sets.
+	if (m_texture_table) { return; }
+	static constexpr auto frame_ratios_v = std::array{
+		vk::DescriptorPoolSize{vk::DescriptorType::eCombinedImageSampler, 1},
+	};
+	auto const frame_allocator_ci = DescriptorAllocator::CreateInfo{
+		.device = *m_device,
+		.ratios = frame_ratios_v,
+		.initial_sets = 4,
+	};
+	for (auto& allocator : m_frame_descriptors) {
+		allocator.emplace(frame_allocator_ci);
+	}
 }
 
 void App::create_pipeline_layout() {
-	static constexpr auto set_0_bindings_v = std::array{
-		layout_binding(0, vk::DescriptorType::eUniformBuffer),
+	auto const zone = trace::Zone{"create_pipeline_layout"};
+	auto const set_0_bindings = std::array{
+		layout_binding(0, get_view_ubo_type()),
 	};
 	static constexpr auto set_1_bindings_v = std::array{
 		layout_binding(0, vk::DescriptorType::eCombinedImageSampler),
 	};
-	static constexpr auto set_2_bindings_v = std::array{
-		layout_binding(0, vk::DescriptorType::eStorageBuffer),
+	// bindings 1 and 2 are only used (and written) with GPU culling.
+	auto const set_2_bindings = std::array{
+		layout_binding(0, get_instance_ssbo_type()),
+		layout_binding(1, vk::DescriptorType::eStorageBuffer),
+		layout_binding(2, vk::DescriptorType::eStorageBuffer),
 	};
 	auto set_layout_cis = std::array<vk::DescriptorSetLayoutCreateInfo, 3>{};
-	set_layout_cis[0].setBindings(set_0_bindings_v);
+	set_layout_cis[0].setBindings(set_0_bindings);
 	set_layout_cis[1].setBindings(set_1_bindings_v);
-	set_layout_cis[2].setBindings(set_2_bindings_v);
+	set_layout_cis[2].setBindings(set_2_bindings);
+	if (m_push_descriptors) {
+		set_layout_cis[2].setFlags(
+			vk::DescriptorSetLayoutCreateFlagBits::ePushDescriptorKHR);
+	}
+	if (m_descriptor_buffer) {
+		for (auto& set_layout_ci : set_layout_cis) {
+			set_layout_ci.setFlags(
+				vk::DescriptorSetLayoutCreateFlagBits::eDescriptorBufferEXT);
+		}
+	}
 
 	for (auto const& set_layout_ci : set_layout_cis) {
 		m_set_layouts.push_back(
 			m_device->createDescriptorSetLayoutUnique(set_layout_ci));
 		m_set_layout_views.push_back(*m_set_layouts.back());
 	}
+	for (std::size_t i = 0; i < set_layout_cis.size(); ++i) {
+		if (!m_descriptor_allocator) { break; }
+		auto const bindings = std::span{set_layout_cis[i].pBindings,
+										set_layout_cis[i].bindingCount};
+		m_descriptor_allocator->add_layout(*m_set_layouts.at(i), bindings);
+		if (i != 1) { continue; }
+		for (auto& allocator : m_frame_descriptors) {
+			if (!allocator) { continue; }
+			allocator->add_layout(*m_set_layouts.at(i), bindings);
+		}
+	}
+	// bindless: set 1 is the texture table.
+	if (m_texture_table) {
+		m_set_layout_views.at(1) = m_texture_table->get_set_layout();
+	}
 
 	auto pipeline_layout_ci = vk::PipelineLayoutCreateInfo{};
 	pipeline_layout_ci.setSetLayouts(m_set_layout_views);
 	m_pipeline_layout =
 		m_device->createPipelineLayoutUnique(pipeline_layout_ci);
+
+	// one per allocated set, writing the bindings in use.
+	auto const set_2_used = std::span{set_2_bindings}.first(
+		m_options.gpu_culling ? set_2_bindings.size() : 1);
+	auto const cache_bindings =
+		std::array<std::span<vk::DescriptorSetLayoutBinding const>, 3>{
+			set_0_bindings, set_1_bindings_v, set_2_used};
+	auto cache_count = m_push_descriptors ? 2uz : 3uz;
+	// update templates cannot write descriptor buffers.
+	if (m_descriptor_buffer) { cache_count = 0; }
+	for (std::size_t i = 0; i < cache_count; ++i) {
+		auto const cache_ci = DescriptorCache::CreateInfo{
+			.device = *m_device,
+			.set_layout = *m_set_layouts.at(i),
+			.bindings = cache_bindings.at(i),
+		};
+		m_descriptor_caches.emplace_back(cache_ci);
+	}
 }
 
 void App::create_shader() {
-	auto const vertex_spirv = to_spir_v(asset_path("shader.vert"));
-	auto const fragment_spirv = to_spir_v(asset_path("shader.frag"));
+	auto const zone = trace::Zone{"create_shader"};
+	auto const load = [this](std::string_view const uri) {
+		auto const load_zone = trace::Zone{"load_spir_v"};
+		return to_spir_v(asset_path(uri));
+	};
+	// load all stages in parallel.
+	// packed instances are expanded to model matrices in the vertex shader.
+	auto const packed = m_options.instance_format == InstanceFormat::Packed;
+	auto vertex_spirv = std::vector<std::uint32_t>{};
+	auto culled_vertex_spirv = std::vector<std::uint32_t>{};
+	auto cull_spirv = std::vector<std::uint32_t>{};
+	// the jobs write the locals above: wait for them on every exit path.
+	auto load_jobs = ScopedJobs{*m_job_system};
+	load_jobs.add(m_job_system->submit([&] {
+		vertex_spirv = load(packed ? "shader_packed.vert" : "shader.vert");
+	}));
+	if (m_options.gpu_culling) {
+		load_jobs.add(m_job_system->submit([&] {
+			culled_vertex_spirv = load(packed ? "shader_packed_culled.vert"
+											  : "shader_culled.vert");
+			cull_spirv = load(packed ? "cull_packed.comp" : "cull.comp");
+		}));
+	}
+	auto const fragment_spirv =
+		load(m_texture_table ? "shader_bindless.frag" : "shader.frag");
+	load_jobs.wait();
 
 	static constexpr auto vertex_input_v = ShaderVertexInput{
 		.attributes = vertex_attributes_v,
 		.bindings = vertex_bindings_v,
 	};
-	auto const shader_ci = ShaderProgram::CreateInfo{
+	auto shader_ci = ShaderProgram::CreateInfo{
 		.device = *m_device,
 		.vertex_spirv = vertex_spirv,
 		.fragment_spirv = fragment_spirv,
@@ -308,51 +709,74 @@ void App::create_shader() {
 		.set_layouts = m_set_layout_views,
 	};
 	m_shader.emplace(shader_ci);
+	if (!m_options.gpu_culling) { return; }
+
+	shader_ci.vertex_spirv = culled_vertex_spirv;
+	m_culled_shader.emplace(shader_ci);
+	auto const cull_shader_ci = ComputeShader::CreateInfo{
+		.device = *m_device,
+		.spirv = cull_spirv,
+		.set_layouts = m_set_layout_views,
+	};
+	m_cull_shader.emplace(cull_shader_ci);
 }
 
 void App::create_cmd_block_pool() {
-	auto command_pool_ci = vk::CommandPoolCreateInfo{};
-	command_pool_ci
-		.setQueueFamilyIndex(m_gpu.queue_family)
-		// this flag indicates that the allocated Command Buffers will be
-		// short-lived.
-		.setFlags(vk::CommandPoolCreateFlagBits::eTransient);
-	m_cmd_block_pool = m_device->createCommandPoolUnique(command_pool_ci);
+	auto const zone = trace::Zone{"create_cmd_block_pool"};
+	auto const pool_ci = CommandBlockPool::CreateInfo{
+		.device = *m_device,
+		.queue = m_queue,
+		.queue_family = m_gpu.queue_family,
+		.timeline = m_timeline ? &*m_timeline : nullptr,
+	};
+	m_cmd_blocks.emplace(pool_ci);
 }
 
-void App::create_shader_resources() {
-	// vertices of a quad.
-	static constexpr auto vertices_v = std::array{
-		Vertex{.position = {-200.0f, -200.0f}, .uv = {0.0f, 1.0f}},
-		Vertex{.position = {200.0f, -200.0f}, .uv = {1.0f, 1.0f}},
-		Vertex{.position = {200.0f, 200.0f}, .uv = {1.0f, 0.0f}},
-		Vertex{.position = {-200.0f, 200.0f}, .uv = {0.0f, 0.0f}},
-	};
-	static constexpr auto indices_v = std::array{
-		0u, 1u, 2u, 2u, 3u, 0u,
-	};
-	static constexpr auto vertices_bytes_v = to_byte_array(vertices_v);
-	static constexpr auto indices_bytes_v = to_byte_array(indices_v);
-	static constexpr auto total_bytes_v =
-		std::array<std::span<std::byte const>, 2>{
-			vertices_bytes_v,
-			indices_bytes_v,
-		};
-	// we want to write total_bytes_v to a Device VertexBuffer | IndexBuffer.
-	auto const buffer_ci = vma::BufferCreateInfo{
+void App::create_staging_ring() {
+	auto const zone = trace::Zone{"create_staging_ring"};
+	auto const staging_ci = StagingRing::CreateInfo{
+		.device = *m_device,
 		.allocator = m_allocator.get(),
-		.usage = vk::BufferUsageFlagBits::eVertexBuffer |
-				 vk::BufferUsageFlagBits::eIndexBuffer,
+		.queue = m_queue,
 		.queue_family = m_gpu.queue_family,
+		.timeline = m_timeline ? &*m_timeline : nullptr,
+		.transfer_queue = m_transfer_queue,
+		.transfer_queue_family = m_gpu.transfer_queue_family.value_or(0),
 	};
-	m_vbo = vma::create_device_buffer(buffer_ci, create_command_block(),
-									  total_bytes_v);
-
-	m_view_ubo.emplace(m_allocator.get(), m_gpu.queue_family,
-					   vk::BufferUsageFlagBits::eUniformBuffer);
+	m_staging.emplace(staging_ci);
+	std::println("[lvk] Staging ring: {} MiB", m_staging->get_capacity() >> 20);
+	if (m_staging->uses_transfer_queue()) {
+		std::println("[lvk] Transfer queue family: {}",
+					 staging_ci.transfer_queue_family);
+	} else {
+		std::println("[lvk] Transfer queue: none (uploads on render queue)");
+	}
+}
 
-	m_instance_ssbo.emplace(m_allocator.get(), m_gpu.queue_family,
-							vk::BufferUsageFlagBits::eStorageBuffer);
+void App::create_shader_resources() {
+	auto const zone = trace::Zone{"create_shader_resources"};
+	create_meshes();
+
+	// dynamic: regions of the shared buffers must be aligned for binding.
+	auto const& limits = m_gpu.properties.limits;
+	auto const dynamic = m_options.dynamic_descriptors;
+	m_view_ubo.emplace(
+		m_allocator.get(), m_gpu.queue_family,
+		vk::BufferUsageFlagBits::eUniformBuffer | get_address_usage(),
+		m_options.frames_in_flight,
+		dynamic ? limits.minUniformBufferOffsetAlignment : 0);
+
+	m_instance_ssbo.emplace(
+		m_allocator.get(), m_gpu.queue_family,
+		vk::BufferUsageFlagBits::eStorageBuffer | get_address_usage(),
+		m_options.frames_in_flight,
+		dynamic ? limits.minStorageBufferOffsetAlignment : 0);
+	create_instances();
+	create_mesh_draws();
+	std::println("[lvk] Meshes: {} (multi-draw indirect: {})",
+				 m_mesh_draws.size(),
+				 m_gpu.features.multiDrawIndirect == vk::True);
+	create_cull_buffers();
 
 	using Pixel = std::array<std::byte, 4>;
 	static constexpr auto rgby_pixels_v = std::array{
@@ -372,15 +796,231 @@ void App::create_shader_resources() {
 		.device = *m_device,
 		.allocator = m_allocator.get(),
 		.queue_family = m_gpu.queue_family,
-		.command_block = create_command_block(),
+		.staging = *m_staging,
+		.samplers = *m_samplers,
 		.bitmap = rgby_bitmap_v,
 	};
 	// use Nearest filtering instead of Linear (interpolation).
 	texture_ci.sampler.setMagFilter(vk::Filter::eNearest);
+	if (!m_options.texture.empty()) {
+		// decoded and uploaded on workers: frames do not wait for it.
+		auto const streamer_ci = TextureStreamer::CreateInfo{
+			.device = *m_device,
+			.allocator = m_allocator.get(),
+			.queue_family = m_gpu.queue_family,
+			.staging = *m_staging,
+			.samplers = *m_samplers,
+			.jobs = *m_job_system,
+		};
+		m_texture_streamer.emplace(streamer_ci);
+		m_streamed_texture =
+			m_texture_streamer->request(m_options.texture, texture_ci.sampler);
+	}
 	m_texture.emplace(std::move(texture_ci));
+	if (m_texture_table) { create_bindless_textures(); }
+
+	// the first frame uses all of the above.
+	m_staging->wait_idle();
+}
+
+void App::create_meshes() {
+	auto const registry_ci = MeshRegistry::CreateInfo{
+		.device = *m_device,
+		.allocator = m_allocator.get(),
+		.queue_family = m_gpu.queue_family,
+		.command_blocks = &*m_cmd_blocks,
+		.staging = &*m_staging,
+	};
+	m_meshes.emplace(registry_ci);
+
+	// vertices of a quad.
+	static constexpr auto vertices_v = std::array{
+		Vertex{.position = {-200.0f, -200.0f}, .uv = {0.0f, 1.0f}},
+		Vertex{.position = {200.0f, -200.0f}, .uv = {1.0f, 1.0f}},
+		Vertex{.position = {200.0f, 200.0f}, .uv = {1.0f, 0.0f}},
+		Vertex{.position = {-200.0f, 200.0f}, .uv = {0.0f, 0.0f}},
+	};
+	static constexpr auto indices_v = std::array{
+		0u, 1u, 2u, 2u, 3u, 0u,
+	};
+	m_mesh_ids.push_back(m_meshes->add(MeshGeometry{
+		.vertices = vertices_v,
+		.indices = indices_v,
+	}));
+	// more shapes, to render a scene of mixed meshes.
+	for (auto const sides : {3u, 5u, 6u, 8u}) {
+		auto const [vertices, indices] = make_polygon(sides);
+		m_mesh_ids.push_back(m_meshes->add(MeshGeometry{
+			.vertices = vertices,
+			.indices = indices,
+		}));
+	}
+}
+
+void App::create_instances() {
+	m_instances.resize(m_options.instance_count);
+	m_pending_instances.resize(m_options.frames_in_flight);
+	auto const packed = m_options.instance_format == InstanceFormat::Packed;
+	std::println("[lvk] Instances: {} ({}, {} bytes each)", m_instances.size(),
+				 packed ? "packed" : "matrix",
+				 packed ? sizeof(PackedInstance) : sizeof(glm::mat4));
+	// the first two instances are the editable quads at the origin, the
+	// rest are small quads in a square grid centered on it.
+	static constexpr std::size_t editable_v{2};
+	static constexpr auto scale_v = 0.05f;
+	static constexpr auto spacing_v = 25.0f;
+	if (m_instances.size() <= editable_v) { return; }
+	auto const count = m_instances.size() - editable_v;
+	auto const columns = static_cast<std::size_t>(
+		std::ceil(std::sqrt(static_cast<float>(count))));
+	auto const offset = 0.5f * spacing_v * static_cast<float>(columns - 1);
+	// tint (packed instances only): red across, green down the grid.
+	auto const to_channel = [columns](float const cell) {
+		auto const value = 255.0f * cell / static_cast<float>(columns);
+		return static_cast<std::uint32_t>(value);
+	};
+	for (std::size_t i = 0; i < count; ++i) {
+		auto const cell = glm::vec2{static_cast<float>(i % columns),
+									static_cast<float>(i / columns)};
+		m_instances.set(editable_v + i,
+						Transform{
+							.position = cell * spacing_v - offset,
+							.scale = glm::vec2{scale_v},
+						});
+		auto const color = to_channel(cell.x) | (to_channel(cell.y) << 8) |
+						   0xffff0000u; // blue and alpha.
+		m_instances.set_color(editable_v + i, color);
+	}
+}
+
+void App::create_mesh_draws() {
+	// instances are split into equal contiguous blocks, one per mesh.
+	auto const mesh_count =
+		std::clamp(m_options.mesh_count, 1uz, m_mesh_ids.size());
+	auto const instance_count = m_instances.size();
+	auto const block_start = [&](std::size_t const mesh) {
+		return static_cast<std::uint32_t>(mesh * instance_count / mesh_count);
+	};
+	m_mesh_draws.clear();
+	for (std::size_t mesh = 0; mesh < mesh_count; ++mesh) {
+		auto const first = block_start(mesh);
+		auto const handle = m_meshes->get_mesh(m_mesh_ids.at(mesh));
+		m_mesh_draws.push_back(
+			handle.draw_command(block_start(mesh + 1) - first, first));
+	}
+	// the cull pass resets each frame's draws to these.
+	m_cull_draws = m_mesh_draws;
+	for (auto& draw : m_cull_draws) { draw.instanceCount = 0; }
+
+	auto const buffer_ci = vma::BufferCreateInfo{
+		.allocator = m_allocator.get(),
+		.usage = vk::BufferUsageFlagBits::eIndirectBuffer,
+		.queue_family = m_gpu.queue_family,
+	};
+	auto const draws = std::as_bytes(std::span{m_mesh_draws});
+	m_mesh_draw_buffer = vma::create_buffer(
+		buffer_ci, vma::BufferMemoryType::Device, draws.size());
+	m_staging->upload_buffer(m_mesh_draw_buffer.get().buffer, 0, draws);
+}
+
+void App::defragment_meshes() {
+	auto const zone = trace::Zone{"defragment_meshes"};
+	// waits for the device to be idle: no frame is using the old buffers.
+	m_meshes->defragment();
+	// mesh locations have changed.
+	create_mesh_draws();
+	// the draws are used by this frame.
+	m_staging->wait_idle();
+}
+
+void App::create_cull_buffers() {
+	if (!m_options.gpu_culling) { return; }
+	m_culling = true;
+	m_cull_buffers.resize(m_options.frames_in_flight);
+	auto buffer_ci = vma::BufferCreateInfo{
+		.allocator = m_allocator.get(),
+		.usage = vk::BufferUsageFlagBits::eStorageBuffer,
+		.queue_family = m_gpu.queue_family,
+	};
+	// buffers cannot be empty.
+	auto const visible_size =
+		std::max(m_instances.size(), 1uz) * sizeof(std::uint32_t);
+	for (auto& buffers : m_cull_buffers) {
+		buffer_ci.usage =
+			vk::BufferUsageFlagBits::eStorageBuffer | get_address_usage();
+		buffers.visible = vma::create_buffer(
+			buffer_ci, vma::BufferMemoryType::Device, visible_size);
+		buffer_ci.usage |= vk::BufferUsageFlagBits::eIndirectBuffer;
+		buffers.draw =
+			vma::create_buffer(buffer_ci, vma::BufferMemoryType::Device,
+							   std::span{m_mesh_draws}.size_bytes());
+	}
+}
+
+void App::create_bindless_textures() {
+	auto const zone = trace::Zone{"create_bindless_textures"};
+	// slot 0: the default texture.
+	auto slots = std::vector<TextureTable::Slot>{};
+	m_default_slot = m_texture_table->add(get_texture_info());
+	slots.push_back(m_default_slot);
+
+	// 2x2 checkers of two colors each, half with Linear filtering.
+	static constexpr std::size_t count_v{15};
+	using Pixel = std::array<std::byte, 4>;
+	auto const to_pixel = [](std::uint32_t const rgb) {
+		return Pixel{static_cast<std::byte>(rgb >> 16),
+					 static_cast<std::byte>(rgb >> 8),
+					 static_cast<std::byte>(rgb), std::byte{0xff}};
+	};
+	m_bindless_textures.reserve(count_v);
+	for (std::size_t i = 0; i < count_v; ++i) {
+		auto const rgb = static_cast<std::uint32_t>((i + 1) * 0x3f5a91);
+		auto const a = to_pixel(rgb | 0x404040);
+		auto const b = to_pixel(~rgb & 0xffffff);
+		auto const pixels = std::array{a, b, b, a};
+		auto const bytes =
+			std::bit_cast<std::array<std::byte, sizeof(pixels)>>(pixels);
+		auto texture_ci = Texture::CreateInfo{
+			.device = *m_device,
+			.allocator = m_allocator.get(),
+			.queue_family = m_gpu.queue_family,
+			.staging = *m_staging,
+			.samplers = *m_samplers,
+			.bitmap = Bitmap{.bytes = bytes, .size = {2, 2}},
+		};
+		if (i % 2 == 0) {
+			texture_ci.sampler.setMagFilter(vk::Filter::eNearest);
+		}
+		auto const& texture =
+			m_bindless_textures.emplace_back(std::move(texture_ci));
+		slots.push_back(m_texture_table->add(texture.descriptor_info()));
+	}
+
+	// all instances are still drawn in one batch.
+	for (std::size_t i = 0; i < m_instances.size(); ++i) {
+		m_instances.set_texture(i, slots.at(i % slots.size()));
+	}
+	std::println("[lvk] Bindless textures: {}, samplers: {}", slots.size(),
+				 m_samplers->get_size());
 }
 
 void App::create_descriptor_sets() {
+	auto const zone = trace::Zone{"create_descriptor_sets"};
+	if (m_descriptor_buffer) {
+		auto const heap_ci = DescriptorHeap::CreateInfo{
+			.device = *m_device,
+			.allocator = m_allocator.get(),
+			.queue_family = m_gpu.queue_family,
+			.properties = *m_gpu.descriptor_buffer,
+			.set_layouts = m_set_layout_views,
+			.buffering = m_options.frames_in_flight,
+		};
+		m_descriptor_heap.emplace(heap_ci);
+		std::println("[lvk] Descriptor heap: {} bytes",
+					 m_descriptor_heap->get_size());
+		return;
+	}
+	m_descriptor_sets.resize(m_options.frames_in_flight);
 	for (auto& descriptor_sets : m_descriptor_sets) {
 		descriptor_sets = allocate_sets();
 	}
@@ -390,20 +1030,39 @@ auto App::asset_path(std::string_view const uri) const -> fs::path {
 	return m_assets_dir / uri;
 }
 
-auto App::create_command_block() const -> CommandBlock {
-	return CommandBlock{*m_device, m_queue, *m_cmd_block_pool};
+auto App::allocate_sets() -> std::vector<vk::DescriptorSet> {
+	// push descriptor sets cannot be allocated, set 1 is the bindless texture
+	// table or allocated every frame.
+	auto layouts = std::vector<vk::DescriptorSetLayout>{};
+	for (std::size_t i = 0; i < m_set_layout_views.size(); ++i) {
+		if (i == 1) { continue; }
+		if (i == 2 && m_push_descriptors) { continue; }
+		layouts.push_back(m_set_layout_views.at(i));
+	}
+	auto ret = m_descriptor_allocator->allocate(layouts);
+	auto const set_1 =
+		m_texture_table ? m_texture_table->get_set() : vk::DescriptorSet{};
+	ret.insert(ret.begin() + 1, set_1);
+	return ret;
+}
+
+auto App::color_format() const -> vk::Format {
+	if (m_offscreen) { return m_offscreen->get_format(); }
+	return m_swapchain->get_format();
 }
 
-auto App::allocate_sets() const -> std::vector<vk::DescriptorSet> {
-	auto allocate_info = vk::DescriptorSetAllocateInfo{};
-	allocate_info.setDescriptorPool(*m_descriptor_pool)
-		.setSetLayouts(m_set_layout_views);
-	return m_device->allocateDescriptorSets(allocate_info);
+auto App::base_barrier() const -> vk::ImageMemoryBarrier2 {
+	if (m_offscreen) { return m_offscreen->base_barrier(); }
+	return m_swapchain->base_barrier();
 }
 
 void App::main_loop() {
 	while (glfwWindowShouldClose(m_window.get()) == GLFW_FALSE) {
-		glfwPollEvents();
+		auto const zone = trace::Zone{"frame"};
+		{
+			auto const poll_zone = trace::Zone{"glfwPollEvents"};
+			glfwPollEvents();
+		}
 		if (!acquire_render_target()) { continue; }
 		auto const command_buffer = begin_frame();
 		transition_for_render(command_buffer);
@@ -413,8 +1072,43 @@ void App::main_loop() {
 	}
 }
 
+void App::headless_loop() {
+	// there is no window to close: render a fixed number of frames as fast as
+	// the device allows, then report throughput.
+	auto const start = std::chrono::steady_clock::now();
+	for (std::uint64_t frame = 0; frame < m_options.frame_count; ++frame) {
+		auto const zone = trace::Zone{"frame"};
+		if (!acquire_render_target()) { continue; }
+		auto const command_buffer = begin_frame();
+		transition_for_render(command_buffer);
+		render(command_buffer);
+		transition_for_present(command_buffer);
+		submit_and_present();
+	}
+	m_device->waitIdle();
+	auto const elapsed = std::chrono::duration<double>(
+		std::chrono::steady_clock::now() - start);
+	auto const frames = static_cast<double>(m_options.frame_count);
+	std::println("[lvk] Headless: {} frames in {:.3f}s ({:.1f} FPS, {:.3f}ms)",
+				 m_options.frame_count, elapsed.count(),
+				 frames / elapsed.count(), 1000.0 * elapsed.count() / frames);
+	for (auto const [index, name] :
+		 std::views::enumerate(PassTimings::pass_names_v)) {
+		auto const pass = static_cast<PassTimings::Pass>(index);
+		auto const summary = m_pass_timings.history(pass).summarize();
+		std::println("[lvk]   GPU {}: min {:.3f}ms avg {:.3f}ms p99 {:.3f}ms",
+					 name, summary.min, summary.avg, summary.p99);
+	}
+	auto const draw_summary = m_draw_cpu_ms.summarize();
+	std::println("[lvk]   CPU draw: min {:.3f}ms avg {:.3f}ms p99 {:.3f}ms",
+				 draw_summary.min, draw_summary.avg, draw_summary.p99);
+}
+
 auto App::acquire_render_target() -> bool {
-	m_framebuffer_size = glfw::framebuffer_size(m_window.get());
+	auto const zone = trace::Zone{"acquire_render_target"};
+	m_framebuffer_size = m_offscreen
+							 ? m_offscreen->get_size()
+							 : glfw::framebuffer_size(m_window.get());
 	// minimized? skip loop.
 	if (m_framebuffer_size.x <= 0 || m_framebuffer_size.y <= 0) {
 		return false;
@@ -425,13 +1119,37 @@ auto App::acquire_render_target() -> bool {
 	// wait for the fence to be signaled.
 	static constexpr auto fence_timeout_v =
 		static_cast<std::uint64_t>(std::chrono::nanoseconds{3s}.count());
-	auto result =
-		m_device->waitForFences(*render_sync.drawn, vk::True, fence_timeout_v);
-	if (result != vk::Result::eSuccess) {
+	auto const waited = [&] {
+		auto const wait_zone = trace::Zone{"wait_for_fence"};
+		if (m_timeline) {
+			// value based wait: no fence to wait on or reset.
+			return m_timeline->wait(render_sync.timeline_value,
+									std::chrono::nanoseconds{3s});
+		}
+		return m_device->waitForFences(*render_sync.drawn, vk::True,
+									   fence_timeout_v) == vk::Result::eSuccess;
+	}();
+	if (!waited) {
 		throw std::runtime_error{"Failed to wait for Render Fence"};
 	}
+	// the frame's previous submission has completed: its timestamps are
+	// available, and its transient descriptor sets are no longer in use.
+	read_timestamps();
+	if (auto& allocator = m_frame_descriptors.at(m_frame_index)) {
+		allocator->reset();
+	}
+	if (m_defragment_requested) {
+		// not in the middle of recording a frame.
+		m_defragment_requested = false;
+		defragment_meshes();
+	}
 
-	m_render_target = m_swapchain->acquire_next_image(*render_sync.draw);
+	if (m_offscreen) {
+		m_render_target = m_offscreen->acquire_next_image();
+	} else {
+		auto const acquire_zone = trace::Zone{"acquire_next_image"};
+		m_render_target = m_swapchain->acquire_next_image(*render_sync.draw);
+	}
 	if (!m_render_target) {
 		// acquire failure => ErrorOutOfDate. Recreate Swapchain.
 		m_swapchain->recreate(m_framebuffer_size);
@@ -440,25 +1158,32 @@ auto App::acquire_render_target() -> bool {
 
 	// reset fence _after_ acquisition of image: if it fails, the
 	// fence remains signaled.
-	m_device->resetFences(*render_sync.drawn);
+	if (!m_timeline) { m_device->resetFences(*render_sync.drawn); }
 	m_imgui->new_frame();
 
 	return true;
 }
 
 auto App::begin_frame() -> vk::CommandBuffer {
-	auto const& render_sync = m_render_sync.at(m_frame_index);
+	auto const zone = trace::Zone{"begin_frame"};
+	auto& render_sync = m_render_sync.at(m_frame_index);
 
 	auto command_buffer_bi = vk::CommandBufferBeginInfo{};
 	// this flag means recorded commands will not be reused.
 	command_buffer_bi.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
 	render_sync.command_buffer.begin(command_buffer_bi);
+	if (render_sync.timestamps) {
+		// queries must be reset before being written again.
+		render_sync.command_buffer.resetQueryPool(*render_sync.timestamps, 0,
+												  timestamp_count_v);
+		render_sync.timestamps_pending = true;
+	}
 	return render_sync.command_buffer;
 }
 
 void App::transition_for_render(vk::CommandBuffer const command_buffer) const {
 	auto dependency_info = vk::DependencyInfo{};
-	auto barrier = m_swapchain->base_barrier();
+	auto barrier = base_barrier();
 	// Undefined => AttachmentOptimal
 	// the barrier must wait for prior color attachment operations to complete,
 	// and block subsequent ones.
@@ -474,6 +1199,7 @@ void App::transition_for_render(vk::CommandBuffer const command_buffer) const {
 }
 
 void App::render(vk::CommandBuffer const command_buffer) {
+	auto const zone = trace::Zone{"render"};
 	auto color_attachment = vk::RenderingAttachmentInfo{};
 	color_attachment.setImageView(m_render_target->image_view)
 		.setImageLayout(vk::ImageLayout::eAttachmentOptimal)
@@ -487,33 +1213,54 @@ void App::render(vk::CommandBuffer const command_buffer) {
 	rendering_info.setRenderArea(render_area)
 		.setColorAttachments(color_attachment)
 		.setLayerCount(1);
+	if (m_secondary_recorder) {
+		// scene draws are recorded into secondary command buffers.
+		rendering_info.setFlags(
+			vk::RenderingFlagBits::eContentsSecondaryCommandBuffers);
+	}
 
-	command_buffer.beginRendering(rendering_info);
+	// uploads completed on the transfer queue become usable from here on.
+	m_upload_wait = m_staging->record_acquires(command_buffer);
+	write_timestamp(command_buffer, 0);
 	inspect();
 	update_view();
+	// before instances are uploaded: may change their texture slots.
+	update_streamed_textures();
 	update_instances();
+	// sets must be written before any command (or thread) binds them.
+	write_descriptor_sets();
+	// culling is part of the scene pass, but must be outside rendering.
+	if (m_culling) { cull(command_buffer); }
+	command_buffer.beginRendering(rendering_info);
 	draw(command_buffer);
 	command_buffer.endRendering();
+	write_timestamp(command_buffer, 1);
 
 	m_imgui->end_frame();
 	// we don't want to clear the image again, instead load it intact after the
 	// previous pass.
 	color_attachment.setLoadOp(vk::AttachmentLoadOp::eLoad);
 	rendering_info.setColorAttachments(color_attachment)
-		.setPDepthAttachment(nullptr);
+		.setPDepthAttachment(nullptr)
+		.setFlags({});
 	command_buffer.beginRendering(rendering_info);
 	m_imgui->render(command_buffer);
 	command_buffer.endRendering();
+	write_timestamp(command_buffer, 2);
 }
 
 void App::transition_for_present(vk::CommandBuffer const command_buffer) const {
+	auto const zone = trace::Zone{"transition_for_present"};
 	auto dependency_info = vk::DependencyInfo{};
-	auto barrier = m_swapchain->base_barrier();
+	auto barrier = base_barrier();
 	// AttachmentOptimal => PresentSrc
 	// the barrier must wait for prior color attachment operations to complete,
 	// and block subsequent ones.
+	// offscreen images cannot be presented, transition them for readback.
+	auto const new_layout = m_offscreen ? vk::ImageLayout::eTransferSrcOptimal
+										: vk::ImageLayout::ePresentSrcKHR;
 	barrier.setOldLayout(vk::ImageLayout::eAttachmentOptimal)
-		.setNewLayout(vk::ImageLayout::ePresentSrcKHR)
+		.setNewLayout(new_layout)
 		.setSrcAccessMask(vk::AccessFlagBits2::eColorAttachmentRead |
 						  vk::AccessFlagBits2::eColorAttachmentWrite)
 		.setSrcStageMask(vk::PipelineStageFlagBits2::eColorAttachmentOutput)
@@ -524,38 +1271,107 @@ void App::transition_for_present(vk::CommandBuffer const command_buffer) const {
 }
 
 void App::submit_and_present() {
-	auto const& render_sync = m_render_sync.at(m_frame_index);
+	auto const zone = trace::Zone{"submit_and_present"};
+	auto& render_sync = m_render_sync.at(m_frame_index);
 	render_sync.command_buffer.end();
 
 	auto submit_info = vk::SubmitInfo2{};
 	auto const command_buffer_info =
 		vk::CommandBufferSubmitInfo{render_sync.command_buffer};
-	auto wait_semaphore_info = vk::SemaphoreSubmitInfo{};
-	wait_semaphore_info.setSemaphore(*render_sync.draw)
-		.setStageMask(vk::PipelineStageFlagBits2::eColorAttachmentOutput);
-	auto signal_semaphore_info = vk::SemaphoreSubmitInfo{};
-	signal_semaphore_info.setSemaphore(m_swapchain->get_present_semaphore())
-		.setStageMask(vk::PipelineStageFlagBits2::eColorAttachmentOutput);
-	submit_info.setCommandBufferInfos(command_buffer_info)
-		.setWaitSemaphoreInfos(wait_semaphore_info)
-		.setSignalSemaphoreInfos(signal_semaphore_info);
-	m_queue.submit2(submit_info, *render_sync.drawn);
+	submit_info.setCommandBufferInfos(command_buffer_info);
+
+	// draw semaphore (unless headless), and transfer timeline (if acquiring).
+	auto wait_semaphore_infos = std::array<vk::SemaphoreSubmitInfo, 2>{};
+	auto wait_count = std::uint32_t{};
+	if (!m_offscreen) {
+		wait_semaphore_infos.at(wait_count++)
+			.setSemaphore(*render_sync.draw)
+			.setStageMask(vk::PipelineStageFlagBits2::eColorAttachmentOutput);
+	}
+	if (m_upload_wait) {
+		wait_semaphore_infos.at(wait_count++) = *m_upload_wait;
+		m_upload_wait.reset();
+	}
+	submit_info.setWaitSemaphoreInfoCount(wait_count)
+		.setPWaitSemaphoreInfos(wait_semaphore_infos.data());
+
+	// present semaphore (unless headless), and timeline value (if enabled).
+	auto signal_semaphore_infos = std::array<vk::SemaphoreSubmitInfo, 2>{};
+	auto signal_count = std::uint32_t{};
+	if (!m_offscreen) {
+		signal_semaphore_infos.at(signal_count++)
+			.setSemaphore(m_swapchain->get_present_semaphore())
+			.setStageMask(vk::PipelineStageFlagBits2::eColorAttachmentOutput);
+	}
+	// submit pending uploads first: the frame may use them on a single queue,
+	// a transfer queue runs them alongside it.
+	m_staging->flush();
+
+	auto fence = *render_sync.drawn;
+	if (m_timeline) {
+		// signal after all commands (including timestamps) have completed.
+		render_sync.timeline_value = m_timeline->next_value();
+		signal_semaphore_infos.at(signal_count++) =
+			m_timeline->signal_info(render_sync.timeline_value);
+		fence = vk::Fence{};
+	}
+	submit_info.setSignalSemaphoreInfoCount(signal_count)
+		.setPSignalSemaphoreInfos(signal_semaphore_infos.data());
+	m_queue.submit2(submit_info, fence);
 
 	m_frame_index = (m_frame_index + 1) % m_render_sync.size();
 	m_render_target.reset();
+	// nothing to present in headless mode.
+	if (m_offscreen) { return; }
 
 	// an eErrorOutOfDateKHR result is not guaranteed if the
 	// framebuffer size does not match the Swapchain image size, check it
 	// explicitly.
 	auto const fb_size_changed = m_framebuffer_size != m_swapchain->get_size();
-	auto const out_of_date = !m_swapchain->present(m_queue);
+	auto const out_of_date = [&] {
+		auto const present_zone = trace::Zone{"present"};
+		return !m_swapchain->present(m_queue);
+	}();
 	if (fb_size_changed || out_of_date) {
 		m_swapchain->recreate(m_framebuffer_size);
 	}
 }
 
+void App::write_timestamp(vk::CommandBuffer const command_buffer,
+						  std::uint32_t const query) const {
+	auto const& render_sync = m_render_sync.at(m_frame_index);
+	if (!render_sync.timestamps) { return; }
+	// written once all previously submitted commands have completed.
+	command_buffer.writeTimestamp2(vk::PipelineStageFlagBits2::eAllCommands,
+								   *render_sync.timestamps, query);
+}
+
+void App::read_timestamps() {
+	auto& render_sync = m_render_sync.at(m_frame_index);
+	if (!render_sync.timestamps_pending) { return; }
+	render_sync.timestamps_pending = false;
+
+	// the frame's fence has been waited on, so this will not block.
+	auto timestamps = std::array<std::uint64_t, timestamp_count_v>{};
+	auto const result = m_device->getQueryPoolResults(
+		*render_sync.timestamps, 0, timestamp_count_v,
+		sizeof(timestamps), timestamps.data(), sizeof(std::uint64_t),
+		vk::QueryResultFlagBits::e64);
+	if (result != vk::Result::eSuccess) { return; }
+
+	auto pass_ms = std::array<float, PassTimings::pass_count_v>{};
+	for (std::size_t i = 0; i < pass_ms.size(); ++i) {
+		// mask off invalid bits, and handle wrap around.
+		auto const ticks =
+			(timestamps.at(i + 1) - timestamps.at(i)) & m_timestamp_mask;
+		pass_ms.at(i) =
+			static_cast<float>(ticks) * m_timestamp_period / 1'000'000.0f;
+	}
+	m_pass_timings.push(pass_ms);
+}
+
 void App::inspect() {
-	ImGui::ShowDemoWindow();
+	m_pass_timings.inspect();
 
 	ImGui::SetNextWindowSize({200.0f, 100.0f}, ImGuiCond_Once);
 	if (ImGui::Begin("Inspect")) {
@@ -570,11 +1386,18 @@ void App::inspect() {
 			ImGui::DragFloat("line width", &m_shader->line_width, 0.25f,
 							 line_width_range[0], line_width_range[1]);
 		}
+		if (m_culled_shader) {
+			m_culled_shader->polygon_mode = m_shader->polygon_mode;
+			m_culled_shader->line_width = m_shader->line_width;
+			ImGui::Checkbox("GPU culling", &m_culling);
+		}
 
+		// returns true if modified.
 		static auto const inspect_transform = [](Transform& out) {
-			ImGui::DragFloat2("position", &out.position.x);
-			ImGui::DragFloat("rotation", &out.rotation);
-			ImGui::DragFloat2("scale", &out.scale.x, 0.1f);
+			auto ret = ImGui::DragFloat2("position", &out.position.x);
+			ret |= ImGui::DragFloat("rotation", &out.rotation);
+			ret |= ImGui::DragFloat2("scale", &out.scale.x, 0.1f);
+			return ret;
 		};
 
 		ImGui::Separator();
@@ -583,12 +1406,88 @@ void App::inspect() {
 			ImGui::TreePop();
 		}
 
+		ImGui::Separator();
+		if (ImGui::TreeNode("Geometry")) {
+			static auto const inspect_arena = [](char const* name,
+												 GeometryArenaStats const& s) {
+				ImGui::Text("%s: %zu / %zu (peak %zu), %zu ranges", name,
+							s.used, s.capacity, s.high_water, s.live_ranges);
+				ImGui::Text("  free ranges: %zu, fragmentation: %.2f",
+							s.free_ranges, double(s.fragmentation()));
+			};
+			inspect_arena("vertices", m_meshes->vertex_stats());
+			inspect_arena("indices", m_meshes->index_stats());
+			static constexpr auto mib_v = double(1 << 20);
+			ImGui::Text("staging: %.2f / %.0f MiB",
+						double(m_staging->get_used()) / mib_v,
+						double(m_staging->get_capacity()) / mib_v);
+			if (ImGui::Button("defragment")) { m_defragment_requested = true; }
+			ImGui::TreePop();
+		}
+
+		ImGui::Separator();
+		if (ImGui::TreeNode("Descriptors")) {
+			ImGui::Text("sets updated: %u, skipped: %u",
+						m_descriptor_stats.updated,
+						m_descriptor_stats.skipped);
+			if (m_descriptor_allocator) {
+				ImGui::Text("pools: %zu, sets: %zu",
+							m_descriptor_allocator->get_pool_count(),
+							m_descriptor_allocator->get_set_count());
+			}
+			if (auto const& allocator = m_frame_descriptors.at(m_frame_index)) {
+				ImGui::Text("transient pools: %zu, sets: %zu",
+							allocator->get_pool_count(),
+							allocator->get_set_count());
+			}
+			if (m_descriptor_heap) {
+				ImGui::Text("descriptor heap: %zu bytes",
+							std::size_t(m_descriptor_heap->get_size()));
+			}
+			if (m_texture_streamer) {
+				ImGui::Text("streamed textures: %zu resident, %zu pending",
+							m_texture_streamer->get_resident_count(),
+							m_texture_streamer->get_pending_count());
+			}
+			ImGui::TreePop();
+		}
+
 		ImGui::Separator();
 		if (ImGui::TreeNode("Instances")) {
-			for (std::size_t i = 0; i < m_instances.size(); ++i) {
+			ImGui::Text("uploaded: %zu / %zu", m_instances_uploaded,
+						m_instances.size());
+			// listing thousands of instances is not useful.
+			static constexpr std::size_t max_listed_v{16};
+			auto const listed = std::min(m_instances.size(), max_listed_v);
+			for (std::size_t i = 0; i < listed; ++i) {
 				auto const label = std::to_string(i);
 				if (ImGui::TreeNode(label.c_str())) {
-					inspect_transform(m_instances.at(i));
+					// only set (and mark dirty) when edited.
+					auto transform = m_instances.get(i);
+					if (inspect_transform(transform)) {
+						m_instances.set(i, transform);
+					}
+					if (m_options.instance_format == InstanceFormat::Packed) {
+						auto color = ImGui::ColorConvertU32ToFloat4(
+							m_instances.get_color(i));
+						if (ImGui::ColorEdit3("color", &color.x)) {
+							m_instances.set_color(
+								i, ImGui::ColorConvertFloat4ToU32(color));
+						}
+						auto texture =
+							static_cast<int>(m_instances.get_texture(i));
+						// streamed textures are added after the others.
+						auto const max_texture =
+							m_texture_table
+								? int(m_texture_table->get_size()) - 1
+								: 0;
+						if (m_texture_table &&
+							ImGui::SliderInt("texture", &texture, 0,
+											 max_texture)) {
+							m_instances.set_texture(
+								i, static_cast<std::uint32_t>(texture));
+						}
+					}
 					ImGui::TreePop();
 				}
 			}
@@ -610,68 +1509,324 @@ void App::update_view() {
 }
 
 void App::update_instances() {
-	m_instance_data.clear();
-	m_instance_data.reserve(m_instances.size());
-	for (auto const& transform : m_instances) {
-		m_instance_data.push_back(transform.model_matrix());
-	}
-	// can't use bit_cast anymore, reinterpret data as a byte array instead.
-	auto const span = std::span{m_instance_data};
-	void* data = span.data();
-	auto const bytes =
-		std::span{static_cast<std::byte const*>(data), span.size_bytes()};
-	m_instance_ssbo->write_at(m_frame_index, bytes);
+	auto const zone = trace::Zone{"update_instances"};
+	// every virtual frame's buffer needs each change, queue them for all.
+	m_dirty_instances.clear();
+	m_instances.take_dirty_ranges(m_dirty_instances);
+	for (auto& pending : m_pending_instances) {
+		pending.insert(pending.end(), m_dirty_instances.begin(),
+					   m_dirty_instances.end());
+	}
+	auto& pending = m_pending_instances.at(m_frame_index);
+	coalesce(pending);
+
+	// write changed instance data straight into the mapped SSBO, in
+	// parallel for large ranges. Unchanged data from this buffer's last
+	// frame is still valid: the size only changes with a resize, which
+	// dirties every instance.
+	static constexpr std::size_t grain_v{16384};
+	auto const count = m_instances.size();
+	auto const packed = m_options.instance_format == InstanceFormat::Packed;
+	auto const stride = packed ? sizeof(PackedInstance) : sizeof(glm::mat4);
+	auto const bytes = m_instance_ssbo->map_at(m_frame_index, count * stride);
+	void* data = bytes.data();
+	m_instances_uploaded = 0;
+	for (auto const& range : pending) {
+		auto const write = [&](std::size_t const begin, std::size_t const end) {
+			auto const first = range.first + begin;
+			auto const length = end - begin;
+			if (packed) {
+				auto const out = std::span{static_cast<PackedInstance*>(data),
+										   count};
+				m_instances.write_packed_instances(
+					first, out.subspan(first, length));
+			} else {
+				auto const out =
+					std::span{static_cast<glm::mat4*>(data), count};
+				m_instances.write_model_matrices(first,
+												 out.subspan(first, length));
+			}
+		};
+		m_job_system->parallel_for(range.count, grain_v, write);
+		m_instances_uploaded += range.count;
+	}
+	pending.clear();
 }
 
-void App::draw(vk::CommandBuffer const command_buffer) const {
-	m_shader->bind(command_buffer, m_framebuffer_size);
+void App::update_streamed_textures() {
+	if (!m_texture_streamer) { return; }
+	auto const resident = m_texture_streamer->update();
+	if (!m_texture_table ||
+		std::ranges::find(resident, *m_streamed_texture) == resident.end()) {
+		// set 1 (or the heap) picks it up when next written.
+		return;
+	}
+	// frames in flight may still sample the placeholder's slot: add the
+	// texture to a new slot and move its instances over instead.
+	auto const slot = m_texture_table->add(get_texture_info());
+	for (std::size_t i = 0; i < m_instances.size(); ++i) {
+		if (m_instances.get_texture(i) == m_default_slot) {
+			m_instances.set_texture(i, slot);
+		}
+	}
+}
+
+void App::cull(vk::CommandBuffer const command_buffer) const {
+	auto const zone = trace::Zone{"cull"};
+	auto const& buffers = m_cull_buffers.at(m_frame_index);
+	// reset the draw commands: the shader accumulates instance counts.
+	auto const draws = std::span{m_cull_draws};
+	command_buffer.updateBuffer(buffers.draw.get().buffer, 0,
+								draws.size_bytes(), draws.data());
+
+	auto barrier = vk::MemoryBarrier2{};
+	barrier.setSrcStageMask(vk::PipelineStageFlagBits2::eTransfer)
+		.setSrcAccessMask(vk::AccessFlagBits2::eTransferWrite)
+		.setDstStageMask(vk::PipelineStageFlagBits2::eComputeShader)
+		.setDstAccessMask(vk::AccessFlagBits2::eShaderStorageRead |
+						  vk::AccessFlagBits2::eShaderStorageWrite);
+	auto dependency_info = vk::DependencyInfo{};
+	dependency_info.setMemoryBarriers(barrier);
+	command_buffer.pipelineBarrier2(dependency_info);
+
+	m_cull_shader->bind(command_buffer);
+	bind_descriptor_sets(command_buffer, vk::PipelineBindPoint::eCompute);
+	// must match local_size_x in cull.comp.
+	static constexpr std::size_t group_size_v{64};
+	auto const groups = (m_instances.size() + group_size_v - 1) / group_size_v;
+	command_buffer.dispatch(static_cast<std::uint32_t>(groups), 1, 1);
+
+	// visible indices are read by the vertex shader, the draw commands by
+	// the indirect draw.
+	barrier.setSrcStageMask(vk::PipelineStageFlagBits2::eComputeShader)
+		.setSrcAccessMask(vk::AccessFlagBits2::eShaderStorageWrite)
+		.setDstStageMask(vk::PipelineStageFlagBits2::eDrawIndirect |
+						 vk::PipelineStageFlagBits2::eVertexShader)
+		.setDstAccessMask(vk::AccessFlagBits2::eIndirectCommandRead |
+						  vk::AccessFlagBits2::eShaderStorageRead);
+	dependency_info.setMemoryBarriers(barrier);
+	command_buffer.pipelineBarrier2(dependency_info);
+}
+
+void App::draw(vk::CommandBuffer const command_buffer) {
+	auto const zone = trace::Zone{"draw"};
+	auto const start = std::chrono::steady_clock::now();
+	auto const draw_count =
+		m_options.draw_calls == 0 ? 1u : m_options.draw_calls;
+	if (m_secondary_recorder) {
+		// split draws evenly across threads, one secondary command buffer each.
+		auto const thread_count = m_secondary_recorder->thread_count();
+		auto const record = [this, draw_count, thread_count](
+								vk::CommandBuffer const secondary,
+								std::size_t const thread_index) {
+			auto const slice = [&](std::size_t const index) {
+				return static_cast<std::uint32_t>(draw_count * index /
+												  thread_count);
+			};
+			auto const first = slice(thread_index);
+			record_draws(secondary, first, slice(thread_index + 1) - first);
+		};
+		auto const secondaries =
+			m_secondary_recorder->record(m_frame_index, record);
+		command_buffer.executeCommands(secondaries);
+	} else {
+		record_draws(command_buffer, 0, draw_count);
+	}
+	m_draw_cpu_ms.push(std::chrono::duration<float, std::milli>(
+						   std::chrono::steady_clock::now() - start)
+						   .count());
+}
+
+void App::record_draws(vk::CommandBuffer const command_buffer,
+					   std::uint32_t const first,
+					   std::uint32_t const count) const {
+	if (count == 0) { return; }
+	// secondary command buffers do not inherit any state: bind everything.
+	auto const& shader = m_culling ? *m_culled_shader : *m_shader;
+	shader.bind(command_buffer, m_framebuffer_size);
 	bind_descriptor_sets(command_buffer);
-	// single VBO at binding 0 at no offset.
-	command_buffer.bindVertexBuffers(0, m_vbo.get().buffer, vk::DeviceSize{});
-	// u32 indices after offset of 4 vertices.
-	command_buffer.bindIndexBuffer(m_vbo.get().buffer, 4 * sizeof(Vertex),
-								   vk::IndexType::eUint32);
+	// all meshes share one vertex and index buffer.
+	m_meshes->bind(command_buffer);
+	if (m_culling) {
+		// instance counts are only known to the GPU.
+		if (first == 0) {
+			auto const& buffers = m_cull_buffers.at(m_frame_index);
+			draw_indirect(command_buffer, buffers.draw.get().buffer);
+		}
+		return;
+	}
+	if (m_options.draw_calls == 0) {
+		// every mesh's block of instances in one call.
+		draw_indirect(command_buffer, m_mesh_draw_buffer.get().buffer);
+		return;
+	}
+	// one draw per instance (cycling over them), to stress recording.
 	auto const instances = static_cast<std::uint32_t>(m_instances.size());
-	// m_vbo has 6 indices.
-	command_buffer.drawIndexed(6, instances, 0, 0, 0);
+	if (instances == 0) { return; }
+	for (auto i = first; i < first + count; ++i) {
+		auto const instance = i % instances;
+		// last mesh whose block starts at or before instance.
+		auto const it = std::ranges::upper_bound(
+			m_mesh_draws, instance, {},
+			&vk::DrawIndexedIndirectCommand::firstInstance);
+		auto const& draw = *std::prev(it);
+		command_buffer.drawIndexed(draw.indexCount, 1, draw.firstIndex,
+								   draw.vertexOffset, instance);
+	}
 }
 
-void App::bind_descriptor_sets(vk::CommandBuffer const command_buffer) const {
-	auto writes = std::array<vk::WriteDescriptorSet, 3>{};
+void App::draw_indirect(vk::CommandBuffer const command_buffer,
+						vk::Buffer const draws) const {
+	static constexpr auto stride_v =
+		static_cast<std::uint32_t>(sizeof(vk::DrawIndexedIndirectCommand));
+	auto const draw_count = static_cast<std::uint32_t>(m_mesh_draws.size());
+	if (m_gpu.features.multiDrawIndirect == vk::True) {
+		command_buffer.drawIndexedIndirect(draws, 0, draw_count, stride_v);
+		return;
+	}
+	// without multiDrawIndirect, drawCount must be 0 or 1.
+	for (std::uint32_t i = 0; i < draw_count; ++i) {
+		command_buffer.drawIndexedIndirect(draws, i * stride_v, 1, stride_v);
+	}
+}
+
+void App::write_descriptor_sets() {
+	m_descriptor_stats = {};
+	if (m_descriptor_heap) {
+		write_descriptor_heap();
+		return;
+	}
+
+	auto& descriptor_sets = m_descriptor_sets.at(m_frame_index);
+	// sets are rewritten only when their resources change, eg when a buffer
+	// grows or the instance count changes.
+	auto const update = [&](std::size_t const set,
+							std::span<DescriptorCache::Info const> infos) {
+		auto& cache = m_descriptor_caches.at(set);
+		if (cache.update(descriptor_sets.at(set), infos)) {
+			++m_descriptor_stats.updated;
+		} else {
+			++m_descriptor_stats.skipped;
+		}
+	};
+
+	auto const set0 = std::array<DescriptorCache::Info, 1>{
+		m_view_ubo->descriptor_info_at(m_frame_index),
+	};
+	update(0, set0);
+
+	// bindless: the texture table is written as textures are added.
+	if (!m_texture_table) {
+		// transient: from this frame's allocator, reset after its fence.
+		auto const layout = m_set_layout_views.at(1);
+		auto& allocator = *m_frame_descriptors.at(m_frame_index);
+		descriptor_sets.at(1) = allocator.allocate({&layout, 1}).front();
+		// the pool may hand out the same handle again, with stale contents.
+		m_descriptor_caches.at(1).forget(descriptor_sets.at(1));
+		auto const set1 = std::array<DescriptorCache::Info, 1>{
+			get_texture_info(),
+		};
+		update(1, set1);
+	}
+
+	// pushed when bound instead.
+	if (m_push_descriptors) { return; }
+
+	auto const infos = get_set_2_infos();
+	auto const set2 = std::array<DescriptorCache::Info, 3>{
+		infos[0],
+		infos[1],
+		infos[2],
+	};
+	update(2, std::span{set2}.first(m_cull_shader ? 3uz : 1uz));
+}
+
+void App::write_descriptor_heap() {
+	// copying descriptors into mapped memory is cheap: write every frame.
+	auto& heap = *m_descriptor_heap;
+	heap.write_buffer(m_frame_index, 0, 0, vk::DescriptorType::eUniformBuffer,
+					  m_view_ubo->descriptor_info_at(m_frame_index));
+	heap.write_image(m_frame_index, 1, 0, get_texture_info());
+	auto const infos = get_set_2_infos();
+	auto const count = m_cull_shader ? infos.size() : 1uz;
+	for (std::size_t i = 0; i < count; ++i) {
+		heap.write_buffer(m_frame_index, 2, static_cast<std::uint32_t>(i),
+						  vk::DescriptorType::eStorageBuffer, infos.at(i));
+	}
+	m_descriptor_stats.updated = 3;
+}
+
+void App::bind_descriptor_sets(vk::CommandBuffer const command_buffer,
+							   vk::PipelineBindPoint const bind_point) const {
+	if (m_descriptor_heap) {
+		m_descriptor_heap->bind(command_buffer, bind_point,
+								*m_pipeline_layout, m_frame_index);
+		return;
+	}
+
 	auto const& descriptor_sets = m_descriptor_sets.at(m_frame_index);
-	auto const set0 = descriptor_sets[0];
-	auto write = vk::WriteDescriptorSet{};
-	auto const view_ubo_info = m_view_ubo->descriptor_info_at(m_frame_index);
-	write.setBufferInfo(view_ubo_info)
-		.setDescriptorType(vk::DescriptorType::eUniformBuffer)
-		.setDescriptorCount(1)
-		.setDstSet(set0)
-		.setDstBinding(0);
-	writes[0] = write;
-
-	auto const set1 = descriptor_sets[1];
-	auto const image_info = m_texture->descriptor_info();
-	write.setImageInfo(image_info)
-		.setDescriptorType(vk::DescriptorType::eCombinedImageSampler)
-		.setDescriptorCount(1)
-		.setDstSet(set1)
-		.setDstBinding(0);
-	writes[1] = write;
-
-	auto const set2 = descriptor_sets[2];
-	auto const instance_ssbo_info =
-		m_instance_ssbo->descriptor_info_at(m_frame_index);
-	write.setBufferInfo(instance_ssbo_info)
-		.setDescriptorType(vk::DescriptorType::eStorageBuffer)
-		.setDescriptorCount(1)
-		.setDstSet(set2)
-		.setDstBinding(0);
-	writes[2] = write;
-
-	m_device->updateDescriptorSets(writes, {});
-
-	command_buffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics,
-									  *m_pipeline_layout, 0, descriptor_sets,
-									  {});
+	command_buffer.bindDescriptorSets(bind_point, *m_pipeline_layout, 0,
+									  descriptor_sets, get_dynamic_offsets());
+	if (!m_push_descriptors) { return; }
+
+	// recorded into the command buffer: no set to allocate or update.
+	auto const infos = get_set_2_infos();
+	auto writes = std::array<vk::WriteDescriptorSet, 3>{};
+	for (std::size_t i = 0; i < writes.size(); ++i) {
+		writes.at(i)
+			.setBufferInfo(infos.at(i))
+			.setDescriptorType(vk::DescriptorType::eStorageBuffer)
+			.setDescriptorCount(1)
+			.setDstBinding(static_cast<std::uint32_t>(i));
+	}
+	auto const count = m_cull_shader ? writes.size() : 1uz;
+	command_buffer.pushDescriptorSetKHR(bind_point, *m_pipeline_layout, 2,
+										std::span{writes}.first(count));
+}
+
+auto App::get_texture_info() const -> vk::DescriptorImageInfo {
+	if (m_streamed_texture) {
+		return m_texture_streamer->descriptor_info(*m_streamed_texture);
+	}
+	return m_texture->descriptor_info();
+}
+
+auto App::get_set_2_infos() const -> std::array<vk::DescriptorBufferInfo, 3> {
+	auto ret = std::array<vk::DescriptorBufferInfo, 3>{};
+	ret[0] = m_instance_ssbo->descriptor_info_at(m_frame_index);
+	if (!m_cull_shader) { return ret; }
+	auto const& cull_buffers = m_cull_buffers.at(m_frame_index);
+	// not WholeSize: descriptor buffers need explicit ranges.
+	auto const& visible = cull_buffers.visible.get();
+	auto const& draw = cull_buffers.draw.get();
+	ret[1] = vk::DescriptorBufferInfo{visible.buffer, 0, visible.size};
+	ret[2] = vk::DescriptorBufferInfo{draw.buffer, 0, draw.size};
+	return ret;
+}
+
+auto App::get_address_usage() const -> vk::BufferUsageFlags {
+	if (!m_descriptor_buffer) { return {}; }
+	return vk::BufferUsageFlagBits::eShaderDeviceAddress;
+}
+
+auto App::get_view_ubo_type() const -> vk::DescriptorType {
+	return m_options.dynamic_descriptors
+			   ? vk::DescriptorType::eUniformBufferDynamic
+			   : vk::DescriptorType::eUniformBuffer;
+}
+
+auto App::get_instance_ssbo_type() const -> vk::DescriptorType {
+	return m_options.dynamic_descriptors
+			   ? vk::DescriptorType::eStorageBufferDynamic
+			   : vk::DescriptorType::eStorageBuffer;
+}
+
+auto App::get_dynamic_offsets() const -> std::vector<std::uint32_t> {
+	if (!m_options.dynamic_descriptors) { return {}; }
+	// in order of set and binding: set 0 binding 0, set 2 binding 0.
+	return {
+		m_view_ubo->dynamic_offset_at(m_frame_index),
+		m_instance_ssbo->dynamic_offset_at(m_frame_index),
+	};
 }
 } // namespace lvk
@@ -1,23 +1,108 @@
 #pragma once
 #include <command_block.hpp>
+#include <compute_shader.hpp>
 #include <dear_imgui.hpp>
+#include <descriptor_allocator.hpp>
 #include <descriptor_buffer.hpp>
+#include <descriptor_cache.hpp>
+#include <descriptor_heap.hpp>
 #include <gpu.hpp>
+#include <job_system.hpp>
+#include <mesh_registry.hpp>
+#include <offscreen.hpp>
+#include <perf_stats.hpp>
 #include <resource_buffering.hpp>
+#include <sampler_cache.hpp>
 #include <scoped_waiter.hpp>
+#include <secondary_recorder.hpp>
 #include <shader_program.hpp>
+#include <staging_ring.hpp>
 #include <swapchain.hpp>
 #include <texture.hpp>
+#include <texture_streamer.hpp>
+#include <texture_table.hpp>
+#include <timeline.hpp>
 #include <transform.hpp>
+#include <transform_batch.hpp>
 #include <vma.hpp>
 #include <window.hpp>
+#include <algorithm>
 #include <filesystem>
+#include <thread>
 
 namespace lvk {
 namespace fs = std::filesystem;
 
+// layout of per-instance data in the instance SSBO.
+enum class InstanceFormat : std::uint8_t {
+	// mat4 model matrices, computed on the CPU.
+	Matrix,
+	// PackedInstance, expanded to a matrix in the vertex shader.
+	Packed,
+};
+
+struct AppOptions {
+	// render into offscreen images: no window, surface or swapchain.
+	bool headless{};
+	// headless only: number of frames to render before exiting, at least 1.
+	std::uint64_t frame_count{1000};
+	// headless only: size of the offscreen render targets.
+	glm::ivec2 extent{1280, 720};
+	// number of virtual frames: 1 to max_resource_buffering_v.
+	std::size_t frames_in_flight{resource_buffering_v};
+	// synchronize frames and uploads with a single timeline semaphore, instead
+	// of per-frame and per-upload fences.
+	bool timeline_sync{};
+	// number of job system worker threads (in addition to the main thread).
+	std::size_t worker_threads{
+		std::max(std::thread::hardware_concurrency(), 2u) - 1};
+	// record scene draws into secondary command buffers on this many threads
+	// (including the main thread), 0 records directly into the primary.
+	std::size_t record_threads{};
+	// benchmark: issue this many single-instance draws instead of one
+	// instanced draw, 0 disables.
+	std::uint32_t draw_calls{};
+	// number of instanced quads, extra ones are laid out in a grid.
+	std::size_t instance_count{2};
+	InstanceFormat instance_format{InstanceFormat::Matrix};
+	// cull instances against the view in a compute pass and draw the visible
+	// ones indirectly. Can be toggled at runtime when enabled.
+	bool gpu_culling{};
+	// number of distinct meshes the instances are split across (at most
+	// the number of built-in meshes).
+	std::size_t mesh_count{1};
+	// upload on a dedicated transfer queue, if the GPU has one.
+	bool transfer_queue{true};
+	// share one ring allocated buffer between all virtual frames for the view
+	// UBO and instance SSBO, bound with dynamic offsets.
+	bool dynamic_descriptors{};
+	// push set 2 (instance and culling buffers) into command buffers instead
+	// of writing pooled sets, if the GPU supports VK_KHR_push_descriptor.
+	// Ignored with dynamic_descriptors: push sets cannot be dynamic.
+	bool push_descriptors{true};
+	// bindless textures: each instance samples a slot of one descriptor
+	// indexing texture table, if supported. Implies packed instances.
+	bool bindless{};
+	// write descriptors straight into buffers (VK_EXT_descriptor_buffer)
+	// instead of pooled sets, if supported. Excludes push and dynamic
+	// descriptors, and bindless textures.
+	bool descriptor_buffer{};
+	// KTX2 file to texture the quads with instead of the built-in bitmap,
+	// if not empty. Streamed in the background: quads are white until it
+	// has been uploaded.
+	fs::path texture{};
+	// write GPU pass timings to this CSV file on exit, if not empty.
+	fs::path perf_csv{};
+	// write CPU zones to this Chrome trace JSON file on exit, if not empty.
+	fs::path trace_json{};
+};
+
 class App {
   public:
+	using Options = AppOptions;
+
+	explicit App(Options const& options = {}) : m_options(options) {}
+
 	void run();
 
   private:
@@ -28,29 +113,62 @@ class App {
 		vk::UniqueFence drawn{};
 		// used to record rendering commands.
 		vk::CommandBuffer command_buffer{};
+		// GPU timestamps at render pass boundaries, null if unsupported.
+		vk::UniqueQueryPool timestamps{};
+		// whether timestamps have been written and not yet read back.
+		bool timestamps_pending{};
+		// timeline mode: value signaled by this frame's last submission.
+		std::uint64_t timeline_value{};
 	};
 
+	// written by the cull compute pass, consumed by the scene draw.
+	struct CullBuffers {
+		// indices of visible instances.
+		vma::Buffer visible{};
+		// vk::DrawIndexedIndirectCommand per mesh.
+		vma::Buffer draw{};
+	};
+
+	// descriptor set writes in a frame.
+	struct DescriptorStats {
+		std::uint32_t updated{};
+		std::uint32_t skipped{};
+	};
+
+	void create_job_system();
 	void create_window();
 	void create_instance();
 	void create_surface();
 	void select_gpu();
 	void create_device();
 	void create_swapchain();
+	void create_offscreen();
 	void create_render_sync();
+	void create_secondary_recorder();
 	void create_imgui();
 	void create_allocator();
-	void create_descriptor_pool();
+	void create_texture_table();
+	void create_descriptor_allocator();
 	void create_pipeline_layout();
 	void create_shader();
 	void create_cmd_block_pool();
+	void create_staging_ring();
 	void create_shader_resources();
+	void create_meshes();
+	void create_instances();
+	void create_mesh_draws();
+	void defragment_meshes();
+	void create_cull_buffers();
+	void create_bindless_textures();
 	void create_descriptor_sets();
 
 	[[nodiscard]] auto asset_path(std::string_view uri) const -> fs::path;
-	[[nodiscard]] auto create_command_block() const -> CommandBlock;
-	[[nodiscard]] auto allocate_sets() const -> std::vector<vk::DescriptorSet>;
+	[[nodiscard]] auto allocate_sets() -> std::vector<vk::DescriptorSet>;
+	[[nodiscard]] auto color_format() const -> vk::Format;
+	[[nodiscard]] auto base_barrier() const -> vk::ImageMemoryBarrier2;
 
 	void main_loop();
+	void headless_loop();
 
 	auto acquire_render_target() -> bool;
 	auto begin_frame() -> vk::CommandBuffer;
@@ -59,16 +177,48 @@ class App {
 	void transition_for_present(vk::CommandBuffer command_buffer) const;
 	void submit_and_present();
 
+	void write_timestamp(vk::CommandBuffer command_buffer,
+						 std::uint32_t query) const;
+	void read_timestamps();
+
 	// ImGui code goes here.
 	void inspect();
 	void update_view();
 	void update_instances();
+	// substitutes streamed textures that have become resident.
+	void update_streamed_textures();
+	void cull(vk::CommandBuffer command_buffer) const;
 	// Issue draw calls here.
-	void draw(vk::CommandBuffer command_buffer) const;
+	void draw(vk::CommandBuffer command_buffer);
+	// records draws [first, first + count) into command_buffer.
+	void record_draws(vk::CommandBuffer command_buffer, std::uint32_t first,
+					  std::uint32_t count) const;
 
-	void bind_descriptor_sets(vk::CommandBuffer command_buffer) const;
+	void draw_indirect(vk::CommandBuffer command_buffer,
+					   vk::Buffer draws) const;
+	void write_descriptor_sets();
+	void write_descriptor_heap();
+	void bind_descriptor_sets(
+		vk::CommandBuffer command_buffer,
+		vk::PipelineBindPoint bind_point = vk::PipelineBindPoint::eGraphics)
+		const;
+	// the streamed texture if requested, else m_texture.
+	[[nodiscard]] auto get_texture_info() const -> vk::DescriptorImageInfo;
+	// instance SSBO, and visible indices and draws if culling (else null).
+	[[nodiscard]] auto get_set_2_infos() const
+		-> std::array<vk::DescriptorBufferInfo, 3>;
+	// ShaderDeviceAddress if buffers are referenced by descriptor buffers.
+	[[nodiscard]] auto get_address_usage() const -> vk::BufferUsageFlags;
+	[[nodiscard]] auto get_view_ubo_type() const -> vk::DescriptorType;
+	[[nodiscard]] auto get_instance_ssbo_type() const -> vk::DescriptorType;
+	// dynamic offsets of the bound sets, empty without dynamic descriptors.
+	[[nodiscard]] auto get_dynamic_offsets() const
+		-> std::vector<std::uint32_t>;
 
+	Options m_options{};
 	fs::path m_assets_dir{};
+	// must outlive every member that submits jobs.
+	std::optional<JobSystem> m_job_system{};
 
 	// the order of these RAII members is crucially important.
 	glfw::Window m_window{};
@@ -76,41 +226,100 @@ class App {
 	vk::UniqueSurfaceKHR m_surface{};
 	Gpu m_gpu{}; // not an RAII member.
 	vk::UniqueDevice m_device{};
-	vk::Queue m_queue{};		  // not an RAII member.
+	vk::Queue m_queue{}; // not an RAII member.
+	// null unless a dedicated transfer queue is used for uploads.
+	vk::Queue m_transfer_queue{};
 	vma::Allocator m_allocator{}; // anywhere between m_device and m_shader.
+	// timeline mode only: signaled by every frame and upload submission.
+	std::optional<Timeline> m_timeline{};
 
 	std::optional<Swapchain> m_swapchain{};
+	// used instead of m_swapchain in headless mode.
+	std::optional<Offscreen> m_offscreen{};
 	// command pool for all render Command Buffers.
 	vk::UniqueCommandPool m_render_cmd_pool{};
-	// command pool for all Command Blocks.
-	vk::UniqueCommandPool m_cmd_block_pool{};
+	// recycled command buffers and fences for Command Blocks.
+	std::optional<CommandBlockPool> m_cmd_blocks{};
+	// asynchronous uploads, flushed before every frame submission.
+	std::optional<StagingRing> m_staging{};
 	// Sync and Command Buffer for virtual frames.
 	Buffered<RenderSync> m_render_sync{};
+	// acquires of uploads recorded into the current frame wait on this.
+	std::optional<vk::SemaphoreSubmitInfo> m_upload_wait{};
 	// Current virtual frame index.
 	std::size_t m_frame_index{};
+	// nanoseconds per timestamp tick.
+	float m_timestamp_period{};
+	std::uint64_t m_timestamp_mask{};
+	PassTimings m_pass_timings{};
+	// CPU time spent recording draws.
+	SampleHistory m_draw_cpu_ms{};
+	// records draws on worker threads, if enabled.
+	std::optional<SecondaryRecorder> m_secondary_recorder{};
 
 	std::optional<DearImGui> m_imgui{};
 
-	vk::UniqueDescriptorPool m_descriptor_pool{};
+	// shared by all textures.
+	std::optional<SamplerCache> m_samplers{};
+	// bindless only: set 1, shared by all frames.
+	std::optional<TextureTable> m_texture_table{};
+
+	// per-frame sets, allocated once: never reset.
+	std::optional<DescriptorAllocator> m_descriptor_allocator{};
+	// transient sets (the texture set unless bindless): reset once the
+	// virtual frame's fence has signaled.
+	Buffered<std::optional<DescriptorAllocator>> m_frame_descriptors{};
 	std::vector<vk::UniqueDescriptorSetLayout> m_set_layouts{};
 	std::vector<vk::DescriptorSetLayout> m_set_layout_views{};
 	vk::UniquePipelineLayout m_pipeline_layout{};
 
 	std::optional<ShaderProgram> m_shader{};
+	// GPU culling only: vertex stage reads instances through visible indices.
+	std::optional<ShaderProgram> m_culled_shader{};
+	std::optional<ComputeShader> m_cull_shader{};
 
-	vma::Buffer m_vbo{};
+	std::optional<MeshRegistry> m_meshes{};
+	std::vector<MeshRegistry::Id> m_mesh_ids{};
+	// one per mesh, drawing its contiguous block of instances.
+	std::vector<vk::DrawIndexedIndirectCommand> m_mesh_draws{};
+	vma::Buffer m_mesh_draw_buffer{};
 	std::optional<DescriptorBuffer> m_view_ubo{};
 	std::optional<Texture> m_texture{};
-	std::vector<glm::mat4> m_instance_data{}; // model matrices.
+	// streams m_options.texture, if set.
+	std::optional<TextureStreamer> m_texture_streamer{};
+	// sampled instead of m_texture (resolves to a placeholder until resident).
+	std::optional<TextureStreamer::Id> m_streamed_texture{};
+	// bindless only: slot of the default texture.
+	TextureTable::Slot m_default_slot{};
+	// bindless only: sampled by instances through the texture table.
+	std::vector<Texture> m_bindless_textures{};
 	std::optional<DescriptorBuffer> m_instance_ssbo{};
+	Buffered<CullBuffers> m_cull_buffers{};
+	std::vector<vk::DrawIndexedIndirectCommand> m_cull_draws{}; // zeroed.
+	// push descriptors: set 2 is pushed, not allocated.
 	Buffered<std::vector<vk::DescriptorSet>> m_descriptor_sets{};
+	bool m_push_descriptors{};
+	bool m_bindless{};
+	bool m_descriptor_buffer{};
+	// descriptor buffer only: replaces the allocator and sets.
+	std::optional<DescriptorHeap> m_descriptor_heap{};
+	// one per allocated set.
+	std::vector<DescriptorCache> m_descriptor_caches{};
+	DescriptorStats m_descriptor_stats{}; // last frame.
 
 	glm::ivec2 m_framebuffer_size{};
 	std::optional<RenderTarget> m_render_target{};
 	bool m_wireframe{};
+	bool m_culling{};
+	// set by the inspector, handled between frames.
+	bool m_defragment_requested{};
 
-	Transform m_view_transform{};			// generates view matrix.
-	std::array<Transform, 2> m_instances{}; // generates model matrices.
+	Transform m_view_transform{}; // generates view matrix.
+	TransformBatch m_instances{}; // generates model matrices.
+	// instance ranges changed since each virtual frame's SSBO was written.
+	Buffered<std::vector<TransformBatch::Range>> m_pending_instances{};
+	std::vector<TransformBatch::Range> m_dirty_instances{}; // scratch.
+	std::size_t m_instances_uploaded{};					// last frame.
 
 	// waiter must be the last member to ensure it blocks until device is idle
 	// before other members get destroyed.
@@ -1,13 +1,15 @@
 #include <command_block.hpp>
+#include <trace.hpp>
 #include <chrono>
-#include <print>
+#include <stdexcept>
 
 namespace lvk {
 using namespace std::chrono_literals;
 
 CommandBlock::CommandBlock(vk::Device const device, vk::Queue const queue,
-						   vk::CommandPool const command_pool)
-	: m_device(device), m_queue(queue) {
+						   vk::CommandPool const command_pool,
+						   Timeline* timeline)
+	: m_device(device), m_queue(queue), m_timeline(timeline) {
 	// allocate a UniqueCommandBuffer which will free the underlying command
 	// buffer from its owning pool on destruction.
 	auto allocate_info = vk::CommandBufferAllocateInfo{};
@@ -25,8 +27,18 @@ CommandBlock::CommandBlock(vk::Device const device, vk::Queue const queue,
 	m_command_buffer->begin(begin_info);
 }
 
+CommandBlock::CommandBlock(CommandBlockPool& pool)
+	: m_device(pool.m_info.device), m_queue(pool.m_info.queue),
+	  m_timeline(pool.m_info.timeline), m_pool(&pool),
+	  m_command_buffer(pool.acquire_command_buffer()) {
+	auto begin_info = vk::CommandBufferBeginInfo{};
+	begin_info.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+	m_command_buffer->begin(begin_info);
+}
+
 void CommandBlock::submit_and_wait() {
 	if (!m_command_buffer) { return; }
+	auto const zone = trace::Zone{"CommandBlock::submit_and_wait"};
 
 	// end recording and submit.
 	m_command_buffer->end();
@@ -34,17 +46,86 @@ void CommandBlock::submit_and_wait() {
 	auto const command_buffer_info =
 		vk::CommandBufferSubmitInfo{*m_command_buffer};
 	submit_info.setCommandBufferInfos(command_buffer_info);
-	auto fence = m_device.createFenceUnique({});
+	static constexpr auto timeout_v = std::chrono::nanoseconds{30s};
+	if (m_timeline != nullptr) {
+		// signal the next timeline value and wait for it: no fence needed.
+		auto const value = m_timeline->next_value();
+		auto const signal_info = m_timeline->signal_info(value);
+		submit_info.setSignalSemaphoreInfos(signal_info);
+		m_queue.submit2(submit_info);
+		if (m_pool != nullptr) { ++m_pool->m_submit_count; }
+		if (!m_timeline->wait(value, timeout_v)) {
+			// the command buffer may still be pending: do not recycle it.
+			throw std::runtime_error{"Failed to submit Command Buffer"};
+		}
+		if (m_pool != nullptr) {
+			m_pool->recycle(std::move(m_command_buffer));
+		}
+		m_command_buffer.reset();
+		return;
+	}
+
+	auto fence = m_pool != nullptr ? m_pool->acquire_fence()
+								   : m_device.createFenceUnique({});
 	m_queue.submit2(submit_info, *fence);
+	if (m_pool != nullptr) { ++m_pool->m_submit_count; }
 
 	// wait for submit fence to be signaled.
-	static constexpr auto timeout_v =
-		static_cast<std::uint64_t>(std::chrono::nanoseconds(30s).count());
-	auto const result = m_device.waitForFences(*fence, vk::True, timeout_v);
+	auto const result = m_device.waitForFences(
+		*fence, vk::True, static_cast<std::uint64_t>(timeout_v.count()));
 	if (result != vk::Result::eSuccess) {
-		std::println(stderr, "Failed to submit Command Buffer");
+		// the command buffer and fence may still be in use: do not recycle.
+		throw std::runtime_error{"Failed to submit Command Buffer"};
+	}
+	// free (or recycle) the command buffer and fence.
+	if (m_pool != nullptr) {
+		m_pool->recycle(std::move(m_command_buffer));
+		m_pool->recycle(std::move(fence));
 	}
-	// free the command buffer.
 	m_command_buffer.reset();
 }
+
+CommandBlockPool::CommandBlockPool(CreateInfo const& create_info)
+	: m_info(create_info) {
+	auto command_pool_ci = vk::CommandPoolCreateInfo{};
+	// recycled command buffers are reset individually.
+	command_pool_ci.setQueueFamilyIndex(m_info.queue_family)
+		.setFlags(vk::CommandPoolCreateFlagBits::eTransient |
+				  vk::CommandPoolCreateFlagBits::eResetCommandBuffer);
+	m_command_pool = m_info.device.createCommandPoolUnique(command_pool_ci);
+}
+
+auto CommandBlockPool::acquire_command_buffer() -> vk::UniqueCommandBuffer {
+	if (!m_free_command_buffers.empty()) {
+		auto ret = std::move(m_free_command_buffers.back());
+		m_free_command_buffers.pop_back();
+		return ret;
+	}
+	auto allocate_info = vk::CommandBufferAllocateInfo{};
+	allocate_info.setCommandPool(*m_command_pool)
+		.setCommandBufferCount(1)
+		.setLevel(vk::CommandBufferLevel::ePrimary);
+	auto command_buffers =
+		m_info.device.allocateCommandBuffersUnique(allocate_info);
+	return std::move(command_buffers.front());
+}
+
+auto CommandBlockPool::acquire_fence() -> vk::UniqueFence {
+	if (!m_free_fences.empty()) {
+		auto ret = std::move(m_free_fences.back());
+		m_free_fences.pop_back();
+		return ret;
+	}
+	return m_info.device.createFenceUnique({});
+}
+
+void CommandBlockPool::recycle(vk::UniqueCommandBuffer command_buffer) {
+	command_buffer->reset();
+	m_free_command_buffers.push_back(std::move(command_buffer));
+}
+
+void CommandBlockPool::recycle(vk::UniqueFence fence) {
+	m_info.device.resetFences(*fence);
+	m_free_fences.push_back(std::move(fence));
+}
 } // namespace lvk
@@ -1,11 +1,21 @@
 #pragma once
+#include <timeline.hpp>
 #include <vulkan/vulkan.hpp>
+#include <cstdint>
+#include <vector>
 
 namespace lvk {
+class CommandBlockPool;
+
 class CommandBlock {
   public:
+	// if timeline is not null, submissions signal and wait on its next value
+	// instead of a dedicated fence.
 	explicit CommandBlock(vk::Device device, vk::Queue queue,
-						  vk::CommandPool command_pool);
+						  vk::CommandPool command_pool,
+						  Timeline* timeline = nullptr);
+	// recycles the command buffer and fence through pool.
+	explicit CommandBlock(CommandBlockPool& pool);
 
 	[[nodiscard]] auto command_buffer() const -> vk::CommandBuffer {
 		return *m_command_buffer;
@@ -16,6 +26,45 @@ class CommandBlock {
   private:
 	vk::Device m_device{};
 	vk::Queue m_queue{};
+	Timeline* m_timeline{};
+	CommandBlockPool* m_pool{};
 	vk::UniqueCommandBuffer m_command_buffer{};
 };
+
+struct CommandBlockPoolCreateInfo {
+	vk::Device device;
+	vk::Queue queue;
+	std::uint32_t queue_family;
+	// if not null, submissions signal its next value instead of a fence.
+	Timeline* timeline{};
+};
+
+// Recycles command buffers and fences for CommandBlocks, and counts their
+// submissions.
+// Not thread safe: use on the thread that owns the queue.
+class CommandBlockPool {
+  public:
+	using CreateInfo = CommandBlockPoolCreateInfo;
+
+	explicit CommandBlockPool(CreateInfo const& create_info);
+
+	// total queue submissions of CommandBlocks.
+	[[nodiscard]] auto get_submit_count() const -> std::uint64_t {
+		return m_submit_count;
+	}
+
+  private:
+	[[nodiscard]] auto acquire_command_buffer() -> vk::UniqueCommandBuffer;
+	[[nodiscard]] auto acquire_fence() -> vk::UniqueFence;
+	void recycle(vk::UniqueCommandBuffer command_buffer);
+	void recycle(vk::UniqueFence fence);
+
+	CreateInfo m_info{};
+	vk::UniqueCommandPool m_command_pool{};
+	std::vector<vk::UniqueCommandBuffer> m_free_command_buffers{};
+	std::vector<vk::UniqueFence> m_free_fences{};
+	std::uint64_t m_submit_count{};
+
+	friend class CommandBlock;
+};
 } // namespace lvk
@@ -0,0 +1,26 @@
+#include <compute_shader.hpp>
+#include <stdexcept>
+
+namespace lvk {
+ComputeShader::ComputeShader(CreateInfo const& create_info) {
+	auto shader_ci = vk::ShaderCreateInfoEXT{};
+	shader_ci.setCodeSize(create_info.spirv.size_bytes())
+		.setPCode(create_info.spirv.data())
+		.setSetLayouts(create_info.set_layouts)
+		.setCodeType(vk::ShaderCodeTypeEXT::eSpirv)
+		.setPName("main")
+		.setStage(vk::ShaderStageFlagBits::eCompute);
+
+	auto result = create_info.device.createShaderEXTUnique(shader_ci);
+	if (result.result != vk::Result::eSuccess) {
+		throw std::runtime_error{"Failed to create Compute Shader Object"};
+	}
+	m_shader = std::move(result.value);
+	m_waiter = create_info.device;
+}
+
+void ComputeShader::bind(vk::CommandBuffer const command_buffer) const {
+	static constexpr auto stage_v = vk::ShaderStageFlagBits::eCompute;
+	command_buffer.bindShadersEXT(stage_v, *m_shader);
+}
+} // namespace lvk
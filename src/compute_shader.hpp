@@ -0,0 +1,26 @@
+#pragma once
+#include <scoped_waiter.hpp>
+#include <vulkan/vulkan.hpp>
+
+namespace lvk {
+struct ComputeShaderCreateInfo {
+	vk::Device device;
+	std::span<std::uint32_t const> spirv;
+	std::span<vk::DescriptorSetLayout const> set_layouts;
+};
+
+// Single compute stage Shader Object.
+class ComputeShader {
+  public:
+	using CreateInfo = ComputeShaderCreateInfo;
+
+	explicit ComputeShader(CreateInfo const& create_info);
+
+	void bind(vk::CommandBuffer command_buffer) const;
+
+  private:
+	vk::UniqueShaderEXT m_shader{};
+
+	ScopedWaiter m_waiter{};
+};
+} // namespace lvk
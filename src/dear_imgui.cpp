@@ -3,7 +3,7 @@
 #include <dear_imgui.hpp>
 #include <glm/gtc/color_space.hpp>
 #include <glm/mat4x4.hpp>
-#include <resource_buffering.hpp>
+#include <algorithm>
 #include <stdexcept>
 
 namespace lvk {
@@ -19,7 +19,11 @@ DearImGui::DearImGui(CreateInfo const& create_info) {
 	ImGui_ImplVulkan_LoadFunctions(create_info.api_version, load_vk_func,
 								   &instance);
 
-	if (!ImGui_ImplGlfw_InitForVulkan(create_info.window, true)) {
+	m_headless = create_info.window == nullptr;
+	if (m_headless) {
+		m_display_size = create_info.display_size;
+		m_frame_start = std::chrono::steady_clock::now();
+	} else if (!ImGui_ImplGlfw_InitForVulkan(create_info.window, true)) {
 		throw std::runtime_error{"Failed to initialize Dear ImGui"};
 	}
 
@@ -31,7 +35,9 @@ DearImGui::DearImGui(CreateInfo const& create_info) {
 	init_info.QueueFamily = create_info.queue_family;
 	init_info.Queue = create_info.queue;
 	init_info.MinImageCount = 2;
-	init_info.ImageCount = static_cast<std::uint32_t>(resource_buffering_v);
+	// the backend needs at least MinImageCount sets of frame buffers.
+	init_info.ImageCount =
+		std::max(create_info.frame_count, init_info.MinImageCount);
 	init_info.MSAASamples =
 		static_cast<VkSampleCountFlagBits>(create_info.samples);
 	init_info.DescriptorPoolSize = 2;
@@ -59,7 +65,17 @@ DearImGui::DearImGui(CreateInfo const& create_info) {
 
 void DearImGui::new_frame() {
 	if (m_state == State::Begun) { end_frame(); }
-	ImGui_ImplGlfw_NewFrame();
+	if (m_headless) {
+		// feed what the GLFW backend would otherwise provide.
+		auto const now = std::chrono::steady_clock::now();
+		auto& io = ImGui::GetIO();
+		io.DisplaySize = m_display_size;
+		io.DeltaTime = std::max(
+			std::chrono::duration<float>(now - m_frame_start).count(), 1e-6f);
+		m_frame_start = now;
+	} else {
+		ImGui_ImplGlfw_NewFrame();
+	}
 	ImGui_ImplVulkan_NewFrame();
 	ImGui::NewFrame();
 	m_state = State::Begun;
@@ -82,7 +98,10 @@ void DearImGui::Deleter::operator()(vk::Device const device) const {
 	device.waitIdle();
 	ImGui_ImplVulkan_DestroyFontsTexture();
 	ImGui_ImplVulkan_Shutdown();
-	ImGui_ImplGlfw_Shutdown();
+	// the GLFW backend is not initialized in headless mode.
+	if (ImGui::GetIO().BackendPlatformUserData != nullptr) {
+		ImGui_ImplGlfw_Shutdown();
+	}
 	ImGui::DestroyContext();
 }
 } // namespace lvk
@@ -3,17 +3,22 @@
 #include <imgui.h>
 #include <scoped.hpp>
 #include <vulkan/vulkan.hpp>
+#include <chrono>
 #include <cstdint>
 
 namespace lvk {
 struct DearImGuiCreateInfo {
+	// null => headless: no platform backend, display_size is used instead.
 	GLFWwindow* window{};
+	ImVec2 display_size{};
 	std::uint32_t api_version{};
 	vk::Instance instance{};
 	vk::PhysicalDevice physical_device{};
 	std::uint32_t queue_family{};
 	vk::Device device{};
 	vk::Queue queue{};
+	// number of virtual frames.
+	std::uint32_t frame_count{};
 	vk::Format color_format{}; // single color attachment.
 	vk::SampleCountFlagBits samples{};
 };
@@ -35,6 +40,9 @@ class DearImGui {
 		void operator()(vk::Device device) const;
 	};
 
+	ImVec2 m_display_size{};
+	std::chrono::steady_clock::time_point m_frame_start{};
+	bool m_headless{};
 	State m_state{};
 
 	Scoped<vk::Device, Deleter> m_device{};
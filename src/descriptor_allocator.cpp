@@ -0,0 +1,131 @@
+#include <descriptor_allocator.hpp>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace lvk {
+DescriptorAllocator::DescriptorAllocator(CreateInfo const& create_info)
+	: m_device(create_info.device),
+	  m_ratios(create_info.ratios.begin(), create_info.ratios.end()),
+	  m_next_sets(std::max(create_info.initial_sets, 1u)),
+	  m_max_sets(std::max(create_info.max_sets, m_next_sets)) {
+	if (m_ratios.empty()) {
+		throw std::invalid_argument{"Invalid DescriptorAllocator CreateInfo"};
+	}
+	m_pools.push_back(create_pool({}));
+}
+
+void DescriptorAllocator::add_layout(
+	vk::DescriptorSetLayout const layout,
+	std::span<vk::DescriptorSetLayoutBinding const> bindings) {
+	auto& counts = m_layouts[static_cast<VkDescriptorSetLayout>(layout)];
+	counts.clear();
+	for (auto const& binding : bindings) {
+		counts[binding.descriptorType] += binding.descriptorCount;
+	}
+}
+
+auto DescriptorAllocator::allocate(
+	std::span<vk::DescriptorSetLayout const> layouts)
+	-> std::vector<vk::DescriptorSet> {
+	auto ret = std::vector<vk::DescriptorSet>{};
+	if (layouts.empty()) { return ret; }
+	observe(layouts);
+	// move on to the next pool (creating it if needed) until one has room.
+	while (!try_allocate(*m_pools.at(m_current), layouts, ret)) {
+		if (++m_current == m_pools.size()) {
+			m_pools.push_back(create_pool(layouts));
+			// a fresh pool with room for these sets must not fail.
+			if (!try_allocate(*m_pools.back(), layouts, ret)) {
+				throw std::runtime_error{"Failed to allocate descriptor sets"};
+			}
+			break;
+		}
+	}
+	m_set_count += layouts.size();
+	return ret;
+}
+
+void DescriptorAllocator::reset() {
+	for (auto const& pool : m_pools) { m_device.resetDescriptorPool(*pool); }
+	m_current = 0;
+	m_set_count = 0;
+}
+
+auto DescriptorAllocator::create_pool(
+	std::span<vk::DescriptorSetLayout const> layouts)
+	-> vk::UniqueDescriptorPool {
+	auto const sets = m_next_sets;
+	m_next_sets = std::min(2 * m_next_sets, m_max_sets);
+
+	// the initial ratios, replaced by the observed average descriptors per
+	// set for types that have been allocated.
+	auto totals = Counts{};
+	for (auto const& ratio : m_ratios) {
+		totals[ratio.type] = std::uint64_t{ratio.descriptorCount} * sets;
+	}
+	for (auto const& [type, count] : m_observed) {
+		auto const per_set = static_cast<double>(count) /
+							 static_cast<double>(m_observed_sets);
+		totals[type] = static_cast<std::uint64_t>(
+			std::ceil(per_set * static_cast<double>(sets)));
+	}
+	// and room for the sets being allocated, whatever the average.
+	for (auto const& [type, count] : count_descriptors(layouts)) {
+		totals[type] += count;
+	}
+
+	auto sizes = std::vector<vk::DescriptorPoolSize>{};
+	for (auto const& [type, count] : totals) {
+		if (count == 0) { continue; }
+		sizes.emplace_back(type, static_cast<std::uint32_t>(count));
+	}
+	auto const max_sets = sets + static_cast<std::uint32_t>(layouts.size());
+	auto pool_ci = vk::DescriptorPoolCreateInfo{};
+	pool_ci.setPoolSizes(sizes).setMaxSets(max_sets);
+	return m_device.createDescriptorPoolUnique(pool_ci);
+}
+
+auto DescriptorAllocator::try_allocate(
+	vk::DescriptorPool const pool,
+	std::span<vk::DescriptorSetLayout const> layouts,
+	std::vector<vk::DescriptorSet>& out) const -> bool {
+	auto allocate_info = vk::DescriptorSetAllocateInfo{};
+	allocate_info.setDescriptorPool(pool).setSetLayouts(layouts);
+	out.resize(layouts.size());
+	// the non-throwing overload: running out of space is expected.
+	auto const result =
+		m_device.allocateDescriptorSets(&allocate_info, out.data());
+	switch (result) {
+	case vk::Result::eSuccess: return true;
+	case vk::Result::eErrorOutOfPoolMemory:
+	case vk::Result::eErrorFragmentedPool: return false;
+	default: throw std::runtime_error{"Failed to allocate descriptor sets"};
+	}
+}
+
+auto DescriptorAllocator::count_descriptors(
+	std::span<vk::DescriptorSetLayout const> layouts) const -> Counts {
+	auto ret = Counts{};
+	for (auto const layout : layouts) {
+		auto const it =
+			m_layouts.find(static_cast<VkDescriptorSetLayout>(layout));
+		if (it == m_layouts.end()) { continue; }
+		for (auto const& [type, count] : it->second) { ret[type] += count; }
+	}
+	return ret;
+}
+
+void DescriptorAllocator::observe(
+	std::span<vk::DescriptorSetLayout const> layouts) {
+	for (auto const layout : layouts) {
+		auto const it =
+			m_layouts.find(static_cast<VkDescriptorSetLayout>(layout));
+		if (it == m_layouts.end()) { continue; }
+		for (auto const& [type, count] : it->second) {
+			m_observed[type] += count;
+		}
+		++m_observed_sets;
+	}
+}
+} // namespace lvk
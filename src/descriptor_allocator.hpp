@@ -0,0 +1,83 @@
+#pragma once
+#include <vulkan/vulkan.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace lvk {
+struct DescriptorAllocatorCreateInfo {
+	vk::Device device;
+	// descriptors of each type per set, used to size pools until layouts
+	// registered with add_layout() have been allocated.
+	std::span<vk::DescriptorPoolSize const> ratios;
+	// sets in the first pool, each new pool doubles it (up to max_sets).
+	std::uint32_t initial_sets{16};
+	std::uint32_t max_sets{4096};
+};
+
+// Allocates descriptor sets from a list of pools, creating a new (larger)
+// pool whenever the current one runs out, so allocation never fails for
+// lack of space. New pools are sized by the descriptors actually allocated
+// so far: the average count of each type per set, from registered layouts.
+// Sets are never freed individually: reset() recycles all pools at once,
+// eg once per frame for transient sets (after the frame's fence).
+// Not thread safe.
+class DescriptorAllocator {
+  public:
+	using CreateInfo = DescriptorAllocatorCreateInfo;
+
+	explicit DescriptorAllocator(CreateInfo const& create_info);
+
+	// records the descriptor counts of layout, for sizing new pools.
+	void add_layout(vk::DescriptorSetLayout layout,
+					std::span<vk::DescriptorSetLayoutBinding const> bindings);
+
+	// allocates one set per layout, in a single call (per pool).
+	[[nodiscard]] auto allocate(
+		std::span<vk::DescriptorSetLayout const> layouts)
+		-> std::vector<vk::DescriptorSet>;
+	// invalidates all allocated sets, pools are kept for reuse.
+	void reset();
+
+	[[nodiscard]] auto get_pool_count() const -> std::size_t {
+		return m_pools.size();
+	}
+	// sets allocated since the last reset.
+	[[nodiscard]] auto get_set_count() const -> std::size_t {
+		return m_set_count;
+	}
+
+  private:
+	using Counts = std::unordered_map<vk::DescriptorType, std::uint64_t>;
+
+	// with room for layouts, in addition to the usual sizing.
+	[[nodiscard]] auto create_pool(
+		std::span<vk::DescriptorSetLayout const> layouts)
+		-> vk::UniqueDescriptorPool;
+	[[nodiscard]] auto try_allocate(
+		vk::DescriptorPool pool,
+		std::span<vk::DescriptorSetLayout const> layouts,
+		std::vector<vk::DescriptorSet>& out) const -> bool;
+	// descriptors of each type in layouts (registered ones only).
+	[[nodiscard]] auto count_descriptors(
+		std::span<vk::DescriptorSetLayout const> layouts) const -> Counts;
+	void observe(std::span<vk::DescriptorSetLayout const> layouts);
+
+	vk::Device m_device{};
+	std::vector<vk::DescriptorPoolSize> m_ratios{};
+	std::uint32_t m_next_sets{};
+	std::uint32_t m_max_sets{};
+
+	std::unordered_map<VkDescriptorSetLayout, Counts> m_layouts{};
+	// descriptors of each type over all sets allocated so far.
+	Counts m_observed{};
+	std::uint64_t m_observed_sets{};
+
+	std::vector<vk::UniqueDescriptorPool> m_pools{};
+	// index of the pool being allocated from, earlier ones are full.
+	std::size_t m_current{};
+	std::size_t m_set_count{};
+};
+} // namespace lvk
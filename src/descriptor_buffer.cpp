@@ -1,43 +1,124 @@
 #include <descriptor_buffer.hpp>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
 
 namespace lvk {
 DescriptorBuffer::DescriptorBuffer(VmaAllocator allocator,
 								   std::uint32_t const queue_family,
-								   vk::BufferUsageFlags const usage)
-	: m_allocator(allocator), m_queue_family(queue_family), m_usage(usage) {
+								   vk::BufferUsageFlags const usage,
+								   std::size_t const buffering,
+								   vk::DeviceSize const dynamic_alignment)
+	: m_allocator(allocator), m_queue_family(queue_family), m_usage(usage),
+	  m_alignment(dynamic_alignment) {
+	m_buffers.resize(buffering);
+	m_retired.resize(buffering);
 	// ensure buffers are created and can be bound after returning.
+	if (is_dynamic()) {
+		for (auto& buffer : m_buffers) { buffer.size = 1; }
+		reserve_regions(0, 1);
+		return;
+	}
 	for (auto& buffer : m_buffers) { write_to(buffer, {}); }
 }
 
 void DescriptorBuffer::write_at(std::size_t const frame_index,
 								std::span<std::byte const> bytes) {
+	if (is_dynamic()) {
+		auto const mapped = map_at(frame_index, bytes.size());
+		if (!bytes.empty()) {
+			std::memcpy(mapped.data(), bytes.data(), bytes.size());
+		}
+		return;
+	}
 	write_to(m_buffers.at(frame_index), bytes);
 }
 
+auto DescriptorBuffer::map_at(std::size_t const frame_index,
+							  vk::DeviceSize const size)
+	-> std::span<std::byte> {
+	auto& buffer = m_buffers.at(frame_index);
+	// buffers cannot be empty.
+	buffer.size = std::max(size, vk::DeviceSize{1});
+	if (!is_dynamic()) {
+		reserve(buffer, buffer.size);
+		return buffer.buffer.get().mapped_span().first(size);
+	}
+	// this frame's previous submission has completed, and with it every
+	// submission that could have used buffers retired back then.
+	m_retired.at(frame_index).clear();
+	reserve_regions(frame_index, buffer.size);
+	return m_shared.get().mapped_span().subspan(
+		dynamic_offset_at(frame_index), size);
+}
+
 auto DescriptorBuffer::descriptor_info_at(std::size_t const frame_index) const
 	-> vk::DescriptorBufferInfo {
 	auto const& buffer = m_buffers.at(frame_index);
 	auto ret = vk::DescriptorBufferInfo{};
-	ret.setBuffer(buffer.buffer.get().buffer).setRange(buffer.size);
+	auto const& vk_buffer = is_dynamic() ? m_shared : buffer.buffer;
+	ret.setBuffer(vk_buffer.get().buffer).setRange(buffer.size);
 	return ret;
 }
 
+auto DescriptorBuffer::dynamic_offset_at(std::size_t const frame_index) const
+	-> std::uint32_t {
+	if (frame_index >= m_buffers.size()) {
+		throw std::out_of_range{"DescriptorBuffer::dynamic_offset_at"};
+	}
+	return static_cast<std::uint32_t>(frame_index * m_region_size);
+}
+
 void DescriptorBuffer::write_to(Buffer& out,
 								std::span<std::byte const> bytes) const {
 	static constexpr auto blank_byte_v = std::array{std::byte{}};
 	// fallback to an empty byte if bytes is empty.
 	if (bytes.empty()) { bytes = blank_byte_v; }
 	out.size = bytes.size();
-	if (out.buffer.get().size < bytes.size()) {
-		// size is too small (or buffer doesn't exist yet), recreate buffer.
-		auto const buffer_ci = vma::BufferCreateInfo{
-			.allocator = m_allocator,
-			.usage = m_usage,
-			.queue_family = m_queue_family,
-		};
-		out.buffer = vma::create_buffer(buffer_ci, vma::BufferMemoryType::Host,
-										out.size);
-	}
+	reserve(out, out.size);
 	std::memcpy(out.buffer.get().mapped, bytes.data(), bytes.size());
 }
+
+void DescriptorBuffer::reserve(Buffer& out, vk::DeviceSize const size) const {
+	if (out.buffer.get().size >= size) { return; }
+	// size is too small (or buffer doesn't exist yet), recreate buffer.
+	out.buffer = create_buffer(size);
+}
+
+void DescriptorBuffer::reserve_regions(std::size_t const frame_index,
+									   vk::DeviceSize const size) {
+	if (m_region_size >= size) { return; }
+	// grow geometrically to amortize reallocations, regions must start at
+	// multiples of the alignment.
+	auto region_size = std::max(2 * m_region_size, size);
+	region_size = (region_size + m_alignment - 1) / m_alignment * m_alignment;
+	auto buffer = create_buffer(region_size * m_buffers.size());
+	if (!buffer.get().buffer) {
+		throw std::runtime_error{"Failed to create DescriptorBuffer"};
+	}
+	// preserve the contents of every region, other frames in flight may
+	// still be reading the current buffer.
+	if (m_shared.get().buffer) {
+		auto const old_bytes = m_shared.get().mapped_span();
+		auto const new_bytes = buffer.get().mapped_span();
+		for (std::size_t i = 0; i < m_buffers.size(); ++i) {
+			auto const count = std::min(m_buffers.at(i).size, m_region_size);
+			std::memcpy(new_bytes.subspan(i * region_size).data(),
+						old_bytes.subspan(i * m_region_size).data(), count);
+		}
+		m_retired.at(frame_index).push_back(std::move(m_shared));
+	}
+	m_shared = std::move(buffer);
+	m_region_size = region_size;
+}
+
+auto DescriptorBuffer::create_buffer(vk::DeviceSize const size) const
+	-> vma::Buffer {
+	auto const buffer_ci = vma::BufferCreateInfo{
+		.allocator = m_allocator,
+		.usage = m_usage,
+		.queue_family = m_queue_family,
+	};
+	return vma::create_buffer(buffer_ci, vma::BufferMemoryType::Host, size);
+}
 } // namespace lvk
@@ -2,30 +2,65 @@
 #include <resource_buffering.hpp>
 #include <vma.hpp>
 #include <cstdint>
+#include <vector>
 
 namespace lvk {
+// Host visible buffer written every frame, one region per virtual frame.
+// By default each frame has its own buffer, recreated at the exact size when
+// it has to grow. With a non-zero dynamic_alignment all frames share a single
+// persistently mapped buffer carved into regions of that alignment, which
+// grows geometrically: bind it as a dynamic descriptor with
+// dynamic_offset_at(). Replaced buffers are retired until the frame that
+// replaced them comes around again, by which time no other frame can be
+// using them.
 class DescriptorBuffer {
   public:
+	// buffering: number of virtual frames.
+	// dynamic_alignment: min offset alignment of the descriptor type.
 	explicit DescriptorBuffer(VmaAllocator allocator,
 							  std::uint32_t queue_family,
-							  vk::BufferUsageFlags usage);
+							  vk::BufferUsageFlags usage,
+							  std::size_t buffering,
+							  vk::DeviceSize dynamic_alignment = 0);
 
 	void write_at(std::size_t frame_index, std::span<std::byte const> bytes);
+	// resizes the buffer at frame_index to size bytes and returns its mapped
+	// memory, to be written to directly. Previous contents are preserved
+	// unless the buffer has to grow.
+	[[nodiscard]] auto map_at(std::size_t frame_index, vk::DeviceSize size)
+		-> std::span<std::byte>;
 
+	// dynamic: offset is 0, add dynamic_offset_at() when binding.
 	[[nodiscard]] auto descriptor_info_at(std::size_t frame_index) const
 		-> vk::DescriptorBufferInfo;
 
+	[[nodiscard]] auto is_dynamic() const -> bool { return m_alignment > 0; }
+	// offset of the region of frame_index, 0 if not dynamic.
+	[[nodiscard]] auto dynamic_offset_at(std::size_t frame_index) const
+		-> std::uint32_t;
+
   private:
 	struct Buffer {
-		vma::Buffer buffer{};
+		vma::Buffer buffer{}; // unused if dynamic.
 		vk::DeviceSize size{};
 	};
 
 	void write_to(Buffer& out, std::span<std::byte const> bytes) const;
+	void reserve(Buffer& out, vk::DeviceSize size) const;
+	// dynamic only: grows regions to at least size bytes.
+	void reserve_regions(std::size_t frame_index, vk::DeviceSize size);
+	[[nodiscard]] auto create_buffer(vk::DeviceSize size) const -> vma::Buffer;
 
 	VmaAllocator m_allocator{};
 	std::uint32_t m_queue_family{};
 	vk::BufferUsageFlags m_usage{};
 	Buffered<Buffer> m_buffers{};
+
+	// dynamic only.
+	vk::DeviceSize m_alignment{};
+	vk::DeviceSize m_region_size{};
+	vma::Buffer m_shared{};
+	// buffers replaced while recording each frame.
+	Buffered<std::vector<vma::Buffer>> m_retired{};
 };
 } // namespace lvk
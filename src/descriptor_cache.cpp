@@ -0,0 +1,56 @@
+#include <descriptor_cache.hpp>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace lvk {
+DescriptorCache::DescriptorCache(CreateInfo const& create_info)
+	: m_device(create_info.device),
+	  m_binding_count(create_info.bindings.size()) {
+	if (m_binding_count == 0) {
+		throw std::invalid_argument{"Invalid DescriptorCache CreateInfo"};
+	}
+	auto entries = std::vector<vk::DescriptorUpdateTemplateEntry>{};
+	entries.reserve(m_binding_count);
+	for (auto const& binding : create_info.bindings) {
+		auto entry = vk::DescriptorUpdateTemplateEntry{};
+		entry.setDstBinding(binding.binding)
+			.setDescriptorCount(1)
+			.setDescriptorType(binding.descriptorType)
+			.setOffset(entries.size() * slot_size_v)
+			.setStride(slot_size_v);
+		entries.push_back(entry);
+	}
+	auto template_ci = vk::DescriptorUpdateTemplateCreateInfo{};
+	template_ci.setDescriptorUpdateEntries(entries)
+		.setTemplateType(vk::DescriptorUpdateTemplateType::eDescriptorSet)
+		.setDescriptorSetLayout(create_info.set_layout);
+	m_template = m_device.createDescriptorUpdateTemplateUnique(template_ci);
+	m_data.resize(m_binding_count * slot_size_v);
+}
+
+auto DescriptorCache::update(vk::DescriptorSet const set,
+							 std::span<Info const> infos) -> bool {
+	if (infos.size() != m_binding_count) {
+		throw std::invalid_argument{"Invalid DescriptorCache infos"};
+	}
+	auto& written = m_written[static_cast<VkDescriptorSet>(set)];
+	if (std::ranges::equal(written, infos)) { return false; }
+
+	for (std::size_t i = 0; i < infos.size(); ++i) {
+		auto* slot = m_data.data() + (i * slot_size_v);
+		std::visit(
+			[slot](auto const& info) {
+				std::memcpy(slot, &info, sizeof(info));
+			},
+			infos[i]);
+	}
+	m_device.updateDescriptorSetWithTemplate(set, *m_template, m_data.data());
+	written.assign(infos.begin(), infos.end());
+	return true;
+}
+
+void DescriptorCache::forget(vk::DescriptorSet const set) {
+	m_written.erase(static_cast<VkDescriptorSet>(set));
+}
+} // namespace lvk
@@ -0,0 +1,47 @@
+#pragma once
+#include <vulkan/vulkan.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace lvk {
+struct DescriptorCacheCreateInfo {
+	vk::Device device;
+	vk::DescriptorSetLayout set_layout;
+	// bindings to write (a subset of set_layout's), one descriptor each.
+	std::span<vk::DescriptorSetLayoutBinding const> bindings;
+};
+
+// Writes descriptor sets of one layout through a descriptor update template,
+// skipping the update if a set's resources are the same as the last ones
+// written to it.
+class DescriptorCache {
+  public:
+	using CreateInfo = DescriptorCacheCreateInfo;
+	using Info =
+		std::variant<vk::DescriptorBufferInfo, vk::DescriptorImageInfo>;
+
+	explicit DescriptorCache(CreateInfo const& create_info);
+
+	// infos: one per binding, in the order passed on creation.
+	// returns true if set was updated, false if the update was skipped.
+	auto update(vk::DescriptorSet set, std::span<Info const> infos) -> bool;
+	// set must be written again, eg after it has been freed and reallocated.
+	void forget(vk::DescriptorSet set);
+
+  private:
+	// template data: one slot per binding.
+	static constexpr auto slot_size_v =
+		std::max(sizeof(vk::DescriptorBufferInfo),
+				 sizeof(vk::DescriptorImageInfo));
+
+	vk::Device m_device{};
+	vk::UniqueDescriptorUpdateTemplate m_template{};
+	std::size_t m_binding_count{};
+	std::unordered_map<VkDescriptorSet, std::vector<Info>> m_written{};
+	std::vector<std::byte> m_data{};
+};
+} // namespace lvk
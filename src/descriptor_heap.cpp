@@ -0,0 +1,120 @@
+#include <descriptor_heap.hpp>
+#include <stdexcept>
+
+namespace lvk {
+namespace {
+constexpr auto align(vk::DeviceSize const size, vk::DeviceSize const alignment)
+	-> vk::DeviceSize {
+	return (size + alignment - 1) / alignment * alignment;
+}
+} // namespace
+
+DescriptorHeap::DescriptorHeap(CreateInfo const& create_info)
+	: m_device(create_info.device), m_properties(create_info.properties),
+	  m_buffering(create_info.buffering) {
+	if (create_info.set_layouts.empty() || m_buffering == 0) {
+		throw std::invalid_argument{"Invalid DescriptorHeap CreateInfo"};
+	}
+	// sets of a frame are packed, each at an aligned offset.
+	auto const alignment = m_properties.descriptorBufferOffsetAlignment;
+	for (auto const layout : create_info.set_layouts) {
+		m_sets.push_back(Set{.layout = layout, .offset = m_frame_size});
+		auto const size = m_device.getDescriptorSetLayoutSizeEXT(layout);
+		m_frame_size += align(size, alignment);
+	}
+
+	// combined image samplers need both usages.
+	m_usage = vk::BufferUsageFlagBits::eResourceDescriptorBufferEXT |
+			  vk::BufferUsageFlagBits::eSamplerDescriptorBufferEXT |
+			  vk::BufferUsageFlagBits::eShaderDeviceAddress;
+	auto const buffer_ci = vma::BufferCreateInfo{
+		.allocator = create_info.allocator,
+		.usage = m_usage,
+		.queue_family = create_info.queue_family,
+	};
+	m_buffer = vma::create_buffer(buffer_ci, vma::BufferMemoryType::Host,
+								  m_frame_size * m_buffering);
+	if (!m_buffer.get().buffer) {
+		throw std::runtime_error{"Failed to create DescriptorHeap buffer"};
+	}
+	auto const address_info =
+		vk::BufferDeviceAddressInfo{m_buffer.get().buffer};
+	m_address = m_device.getBufferAddress(address_info);
+}
+
+void DescriptorHeap::write_buffer(std::size_t const frame_index,
+								  std::uint32_t const set,
+								  std::uint32_t const binding,
+								  vk::DescriptorType const type,
+								  vk::DescriptorBufferInfo const& info) {
+	auto const buffer_address =
+		m_device.getBufferAddress(vk::BufferDeviceAddressInfo{info.buffer});
+	auto address_info = vk::DescriptorAddressInfoEXT{};
+	address_info.setAddress(buffer_address + info.offset)
+		.setRange(info.range);
+	auto get_info = vk::DescriptorGetInfoEXT{};
+	get_info.setType(type);
+	switch (type) {
+	case vk::DescriptorType::eUniformBuffer:
+		get_info.data.setPUniformBuffer(&address_info);
+		write(frame_index, set, binding, get_info,
+			  m_properties.uniformBufferDescriptorSize);
+		break;
+	case vk::DescriptorType::eStorageBuffer:
+		get_info.data.setPStorageBuffer(&address_info);
+		write(frame_index, set, binding, get_info,
+			  m_properties.storageBufferDescriptorSize);
+		break;
+	default: throw std::invalid_argument{"Unsupported DescriptorHeap type"};
+	}
+}
+
+void DescriptorHeap::write_image(std::size_t const frame_index,
+								 std::uint32_t const set,
+								 std::uint32_t const binding,
+								 vk::DescriptorImageInfo const& info) {
+	auto get_info = vk::DescriptorGetInfoEXT{};
+	get_info.setType(vk::DescriptorType::eCombinedImageSampler);
+	get_info.data.setPCombinedImageSampler(&info);
+	write(frame_index, set, binding, get_info,
+		  m_properties.combinedImageSamplerDescriptorSize);
+}
+
+void DescriptorHeap::bind(vk::CommandBuffer const command_buffer,
+						  vk::PipelineBindPoint const bind_point,
+						  vk::PipelineLayout const layout,
+						  std::size_t const frame_index) const {
+	if (frame_index >= m_buffering) {
+		throw std::out_of_range{"DescriptorHeap::bind"};
+	}
+	auto binding_info = vk::DescriptorBufferBindingInfoEXT{};
+	binding_info.setAddress(m_address).setUsage(m_usage);
+	command_buffer.bindDescriptorBuffersEXT(binding_info);
+
+	// every set is in the only bound buffer (index 0).
+	auto const base = frame_index * m_frame_size;
+	auto indices = std::vector<std::uint32_t>(m_sets.size());
+	auto offsets = std::vector<vk::DeviceSize>{};
+	offsets.reserve(m_sets.size());
+	for (auto const& set : m_sets) { offsets.push_back(base + set.offset); }
+	command_buffer.setDescriptorBufferOffsetsEXT(bind_point, layout, 0,
+												 indices, offsets);
+}
+
+void DescriptorHeap::write(std::size_t const frame_index,
+						   std::uint32_t const set,
+						   std::uint32_t const binding,
+						   vk::DescriptorGetInfoEXT const& info,
+						   std::size_t const size) {
+	if (frame_index >= m_buffering) {
+		throw std::out_of_range{"DescriptorHeap::write"};
+	}
+	auto const& target = m_sets.at(set);
+	auto const binding_offset =
+		m_device.getDescriptorSetLayoutBindingOffsetEXT(target.layout, binding);
+	auto const offset =
+		(frame_index * m_frame_size) + target.offset + binding_offset;
+	auto const bytes = m_buffer.get().mapped_span().subspan(offset, size);
+	m_device.getDescriptorEXT(info, bytes.size(), bytes.data());
+}
+} // namespace lvk
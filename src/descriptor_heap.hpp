@@ -0,0 +1,68 @@
+#pragma once
+#include <vma.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace lvk {
+struct DescriptorHeapCreateInfo {
+	vk::Device device;
+	VmaAllocator allocator;
+	std::uint32_t queue_family;
+	vk::PhysicalDeviceDescriptorBufferPropertiesEXT properties;
+	// created with the DescriptorBufferEXT flag, in order of set index.
+	std::span<vk::DescriptorSetLayout const> set_layouts;
+	// number of virtual frames: each has its own copy of every set.
+	std::size_t buffering;
+};
+
+// Descriptor sets without pools or sets (VK_EXT_descriptor_buffer):
+// descriptors are written straight into a persistently mapped buffer, and
+// bound by address and offset. Each virtual frame has a region holding all
+// its sets, which must only be written once the frame's previous
+// submission has completed.
+class DescriptorHeap {
+  public:
+	using CreateInfo = DescriptorHeapCreateInfo;
+
+	explicit DescriptorHeap(CreateInfo const& create_info);
+
+	// uniform or storage buffer descriptor, info.range cannot be WholeSize.
+	void write_buffer(std::size_t frame_index, std::uint32_t set,
+					  std::uint32_t binding, vk::DescriptorType type,
+					  vk::DescriptorBufferInfo const& info);
+	// combined image sampler descriptor.
+	void write_image(std::size_t frame_index, std::uint32_t set,
+					 std::uint32_t binding,
+					 vk::DescriptorImageInfo const& info);
+
+	// binds the heap and points sets [0, N) at frame_index's region.
+	void bind(vk::CommandBuffer command_buffer,
+			  vk::PipelineBindPoint bind_point, vk::PipelineLayout layout,
+			  std::size_t frame_index) const;
+
+	[[nodiscard]] auto get_size() const -> vk::DeviceSize {
+		return m_buffer.get().size;
+	}
+
+  private:
+	struct Set {
+		vk::DescriptorSetLayout layout{};
+		vk::DeviceSize offset{}; // within a frame's region.
+	};
+
+	void write(std::size_t frame_index, std::uint32_t set,
+			   std::uint32_t binding, vk::DescriptorGetInfoEXT const& info,
+			   std::size_t size);
+
+	vk::Device m_device{};
+	vk::PhysicalDeviceDescriptorBufferPropertiesEXT m_properties{};
+	std::vector<Set> m_sets{};
+	vk::DeviceSize m_frame_size{};
+	std::size_t m_buffering{};
+	vma::Buffer m_buffer{};
+	vk::DeviceAddress m_address{};
+	vk::BufferUsageFlags m_usage{};
+};
+} // namespace lvk
@@ -0,0 +1,201 @@
+#include <geometry_arena.hpp>
+#include <trace.hpp>
+#include <algorithm>
+#include <stdexcept>
+
+namespace lvk {
+GeometryArena::GeometryArena(CreateInfo create_info)
+	: m_info(std::move(create_info)) {
+	if (m_info.element_size == 0 || m_info.command_blocks == nullptr ||
+		m_info.staging == nullptr) {
+		throw std::invalid_argument{"Invalid GeometryArena CreateInfo"};
+	}
+	replace_buffer(std::max(m_info.capacity, 1uz), {});
+	reset_free_list(0);
+}
+
+auto GeometryArena::upload(std::span<std::byte const> bytes) -> Id {
+	auto const element_size = static_cast<std::size_t>(m_info.element_size);
+	if (bytes.size() % element_size != 0) {
+		throw std::invalid_argument{"Size is not a multiple of element size"};
+	}
+	auto const count = bytes.size() / element_size;
+	auto const range = Range{
+		.first = count == 0 ? 0 : allocate(count),
+		.count = count,
+	};
+
+	auto id = Id{};
+	if (m_free_ids.empty()) {
+		id = static_cast<Id>(m_slots.size());
+		m_slots.emplace_back();
+	} else {
+		id = m_free_ids.back();
+		m_free_ids.pop_back();
+	}
+	m_slots.at(id) = Slot{.range = range, .live = true};
+	if (count == 0) { return id; }
+
+	auto const dst_offset = range.first * m_info.element_size;
+	// usable by any submission after the ring's next flush.
+	m_info.staging->upload_buffer(m_buffer.get().buffer, dst_offset, bytes);
+	return id;
+}
+
+void GeometryArena::release(Id const id) {
+	auto& slot = m_slots.at(id);
+	if (!slot.live) { return; }
+	free(slot.range);
+	slot = {};
+	m_free_ids.push_back(id);
+}
+
+auto GeometryArena::get_range(Id const id) const -> Range {
+	auto const& slot = m_slots.at(id);
+	if (!slot.live) { throw std::out_of_range{"Range has been released"}; }
+	return slot.range;
+}
+
+auto GeometryArena::get_stats() const -> GeometryArenaStats {
+	return GeometryArenaStats{
+		.capacity = m_capacity,
+		.used = m_used,
+		.high_water = m_high_water,
+		.largest_free =
+			m_free_by_count.empty() ? 0 : m_free_by_count.rbegin()->first,
+		.live_ranges = m_slots.size() - m_free_ids.size(),
+		.free_ranges = m_free_by_offset.size(),
+	};
+}
+
+void GeometryArena::defragment() {
+	auto const zone = trace::Zone{"GeometryArena::defragment"};
+	// pack live ranges to the front, preserving their order.
+	auto live = std::vector<Slot*>{};
+	for (auto& slot : m_slots) {
+		if (slot.live && slot.range.count > 0) { live.push_back(&slot); }
+	}
+	std::ranges::sort(live, {}, [](Slot const* s) { return s->range.first; });
+
+	auto regions = std::vector<vk::BufferCopy2>{};
+	regions.reserve(live.size());
+	auto end = 0uz;
+	for (auto* slot : live) {
+		auto region = vk::BufferCopy2{};
+		region.setSrcOffset(slot->range.first * m_info.element_size)
+			.setDstOffset(end * m_info.element_size)
+			.setSize(slot->range.count * m_info.element_size);
+		regions.push_back(region);
+		slot->range.first = end;
+		end += slot->range.count;
+	}
+	// overlapping regions cannot be copied within a buffer: use a new one.
+	replace_buffer(m_capacity, regions);
+	reset_free_list(end);
+}
+
+auto GeometryArena::allocate(std::size_t const count) -> std::size_t {
+	auto it = m_free_by_count.lower_bound(count);
+	if (it == m_free_by_count.end()) {
+		grow(std::max(2 * m_capacity, m_capacity + count));
+		it = m_free_by_count.lower_bound(count);
+	}
+	// best fit: smallest free range that is large enough.
+	auto const [size, offset] = *it;
+	m_free_by_count.erase(it);
+	m_free_by_offset.erase(offset);
+	if (size > count) {
+		m_free_by_offset.emplace(offset + count, size - count);
+		m_free_by_count.emplace(size - count, offset + count);
+	}
+	m_used += count;
+	m_high_water = std::max(m_high_water, m_used);
+	return offset;
+}
+
+void GeometryArena::free(Range const range) {
+	if (range.count == 0) { return; }
+	m_used -= range.count;
+	insert_free(range);
+}
+
+void GeometryArena::insert_free(Range range) {
+	auto const erase_by_count = [this](std::size_t offset, std::size_t size) {
+		auto [first, last] = m_free_by_count.equal_range(size);
+		auto const it = std::find_if(first, last, [offset](auto const& entry) {
+			return entry.second == offset;
+		});
+		m_free_by_count.erase(it);
+	};
+	// coalesce with the free ranges before and after.
+	auto next = m_free_by_offset.lower_bound(range.first);
+	if (next != m_free_by_offset.begin()) {
+		auto const prev = std::prev(next);
+		if (prev->first + prev->second == range.first) {
+			erase_by_count(prev->first, prev->second);
+			range = Range{.first = prev->first,
+						  .count = prev->second + range.count};
+			m_free_by_offset.erase(prev);
+		}
+	}
+	if (next != m_free_by_offset.end() &&
+		range.first + range.count == next->first) {
+		erase_by_count(next->first, next->second);
+		range.count += next->second;
+		m_free_by_offset.erase(next);
+	}
+	m_free_by_offset.emplace(range.first, range.count);
+	m_free_by_count.emplace(range.count, range.first);
+}
+
+void GeometryArena::grow(std::size_t const min_capacity) {
+	auto const zone = trace::Zone{"GeometryArena::grow"};
+	auto const old_capacity = m_capacity;
+	// live ranges keep their offsets.
+	auto region = vk::BufferCopy2{};
+	region.setSize(old_capacity * m_info.element_size);
+	replace_buffer(min_capacity, {&region, 1});
+	// the new space is free (and merges with a free tail, if any).
+	insert_free(
+		Range{.first = old_capacity, .count = m_capacity - old_capacity});
+}
+
+void GeometryArena::replace_buffer(std::size_t const capacity,
+								   std::span<vk::BufferCopy2 const> regions) {
+	auto const buffer_ci = vma::BufferCreateInfo{
+		.allocator = m_info.allocator,
+		.usage = m_info.usage | vk::BufferUsageFlagBits::eTransferSrc,
+		.queue_family = m_info.queue_family,
+	};
+	auto buffer = vma::create_buffer(buffer_ci, vma::BufferMemoryType::Device,
+									 capacity * m_info.element_size);
+	if (!buffer.get().buffer) {
+		throw std::runtime_error{"Failed to create GeometryArena buffer"};
+	}
+	if (m_buffer.get().buffer && !regions.empty()) {
+		// staged uploads into the old buffer must be complete (and owned by
+		// the copying queue) first.
+		m_info.staging->wait_idle();
+		auto copy_buffer_info = vk::CopyBufferInfo2{};
+		copy_buffer_info.setSrcBuffer(m_buffer.get().buffer)
+			.setDstBuffer(buffer.get().buffer)
+			.setRegions(regions);
+		auto command_block = CommandBlock{*m_info.command_blocks};
+		command_block.command_buffer().copyBuffer2(copy_buffer_info);
+		command_block.submit_and_wait();
+	}
+	// frames in flight may still be reading the old buffer.
+	if (m_buffer.get().buffer) { m_info.device.waitIdle(); }
+	m_buffer = std::move(buffer);
+	m_capacity = capacity;
+}
+
+void GeometryArena::reset_free_list(std::size_t const used_end) {
+	m_free_by_offset.clear();
+	m_free_by_count.clear();
+	if (used_end < m_capacity) {
+		m_free_by_offset.emplace(used_end, m_capacity - used_end);
+		m_free_by_count.emplace(m_capacity - used_end, used_end);
+	}
+}
+} // namespace lvk
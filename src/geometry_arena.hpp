@@ -0,0 +1,105 @@
+#pragma once
+#include <command_block.hpp>
+#include <staging_ring.hpp>
+#include <vma.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <span>
+#include <vector>
+
+namespace lvk {
+struct GeometryArenaCreateInfo {
+	vk::Device device;
+	VmaAllocator allocator;
+	vk::BufferUsageFlags usage;
+	std::uint32_t queue_family;
+	// for copies into a replacement buffer.
+	CommandBlockPool* command_blocks;
+	// uploads are staged through it.
+	StagingRing* staging;
+	// size of one element (vertex / index) in bytes, ranges are in elements.
+	vk::DeviceSize element_size;
+	// initial capacity in elements, the buffer grows as needed.
+	std::size_t capacity{1 << 16};
+};
+
+struct GeometryArenaStats {
+	std::size_t capacity{};		// elements.
+	std::size_t used{};			// elements in live ranges.
+	std::size_t high_water{};	// peak of used.
+	std::size_t largest_free{}; // largest contiguous free range.
+	std::size_t live_ranges{};
+	std::size_t free_ranges{};
+
+	// 0 when all free space is contiguous, approaching 1 as it splinters.
+	[[nodiscard]] auto fragmentation() const -> float {
+		auto const free = capacity - used;
+		if (free == 0) { return 0.0f; }
+		return 1.0f - static_cast<float>(largest_free) /
+						  static_cast<float>(free);
+	}
+};
+
+// Suballocates ranges of elements from a single device buffer with a best-fit
+// free list, so the number of buffers (and VMA allocations) stays flat as
+// ranges come and go. Running out of space grows the buffer, and
+// defragment() compacts live ranges to the front, both with GPU copies.
+// Both replace the buffer and wait for the device to be idle first: ranges'
+// locations and the buffer must be queried again afterwards.
+class GeometryArena {
+  public:
+	using CreateInfo = GeometryArenaCreateInfo;
+	// stable identifier of a range, valid until released.
+	using Id = std::uint32_t;
+
+	struct Range {
+		std::size_t first{}; // in elements.
+		std::size_t count{};
+	};
+
+	explicit GeometryArena(CreateInfo create_info);
+
+	// allocates a range of bytes.size() / element_size elements and uploads
+	// bytes into it through the staging ring.
+	[[nodiscard]] auto upload(std::span<std::byte const> bytes) -> Id;
+	void release(Id id);
+
+	[[nodiscard]] auto get_range(Id id) const -> Range;
+	[[nodiscard]] auto get_buffer() const -> vk::Buffer {
+		return m_buffer.get().buffer;
+	}
+	[[nodiscard]] auto get_stats() const -> GeometryArenaStats;
+
+	void defragment();
+
+  private:
+	struct Slot {
+		Range range{};
+		bool live{};
+	};
+
+	[[nodiscard]] auto allocate(std::size_t count) -> std::size_t;
+	void free(Range range);
+	// adds range to the free list, coalescing with its neighbours.
+	void insert_free(Range range);
+	void grow(std::size_t min_capacity);
+	// creates a new buffer of capacity elements and copies regions into it.
+	void replace_buffer(std::size_t capacity,
+						std::span<vk::BufferCopy2 const> regions);
+	void reset_free_list(std::size_t used_end);
+
+	CreateInfo m_info{};
+	vma::Buffer m_buffer{};
+	std::size_t m_capacity{};
+	std::size_t m_used{};
+	std::size_t m_high_water{};
+
+	// free ranges: offset => count, and count => offset for best-fit.
+	std::map<std::size_t, std::size_t> m_free_by_offset{};
+	std::multimap<std::size_t, std::size_t> m_free_by_count{};
+
+	std::vector<Slot> m_slots{};
+	std::vector<Id> m_free_ids{};
+};
+} // namespace lvk
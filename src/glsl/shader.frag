@@ -1,12 +1,29 @@
 #version 450 core
 
+// compile with -DBINDLESS to sample each instance's texture table slot
+// (written by shader_packed.vert).
+
+#if defined(BINDLESS)
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout (set = 1, binding = 0) uniform sampler2D textures[];
+
+layout (location = 2) flat in uint in_texture;
+
+vec4 sample_texture(vec2 uv) {
+	return texture(textures[nonuniformEXT(in_texture)], uv);
+}
+#else
 layout (set = 1, binding = 0) uniform sampler2D tex;
 
+vec4 sample_texture(vec2 uv) { return texture(tex, uv); }
+#endif
+
 layout (location = 0) in vec3 in_color;
 layout (location = 1) in vec2 in_uv;
 
 layout (location = 0) out vec4 out_color;
 
 void main() {
-	out_color = vec4(in_color, 1.0) * texture(tex, in_uv);
+	out_color = vec4(in_color, 1.0) * sample_texture(in_uv);
 }
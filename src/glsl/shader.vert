@@ -1,5 +1,7 @@
 #version 450 core
 
+// compile with -DCULLED to read instances through cull.comp's indices.
+
 layout (location = 0) in vec2 a_pos;
 layout (location = 1) in vec3 a_color;
 layout (location = 2) in vec2 a_uv;
@@ -12,11 +14,22 @@ layout (set = 2, binding = 0) readonly buffer Instances {
 	mat4 mat_ms[];
 };
 
+#if defined(CULLED)
+// compacted indices of visible instances, written by cull.comp.
+layout (set = 2, binding = 1) readonly buffer Visible {
+	uint visible[];
+};
+
+uint instance_index() { return visible[gl_InstanceIndex]; }
+#else
+uint instance_index() { return gl_InstanceIndex; }
+#endif
+
 layout (location = 0) out vec3 out_color;
 layout (location = 1) out vec2 out_uv;
 
 void main() {
-	const mat4 mat_m = mat_ms[gl_InstanceIndex];
+	const mat4 mat_m = mat_ms[instance_index()];
 	const vec4 world_pos = mat_m * vec4(a_pos, 0.0, 1.0);
 
 	out_color = a_color;
@@ -0,0 +1,56 @@
+#version 450 core
+
+// compile with -DCULLED to read instances through cull.comp's indices.
+
+layout (location = 0) in vec2 a_pos;
+layout (location = 1) in vec3 a_color;
+layout (location = 2) in vec2 a_uv;
+
+layout (set = 0, binding = 0) uniform View {
+	mat4 mat_vp;
+};
+
+// must match lvk::PackedInstance.
+struct Instance {
+	vec2 position;
+	vec2 scale;
+	float rotation; // degrees.
+	uint color;		// RGBA8.
+	uint texture;	// bindless texture table slot.
+	uint reserved;
+};
+
+layout (set = 2, binding = 0) readonly buffer Instances {
+	Instance instances[];
+};
+
+#if defined(CULLED)
+// compacted indices of visible instances, written by cull.comp.
+layout (set = 2, binding = 1) readonly buffer Visible {
+	uint visible[];
+};
+
+uint instance_index() { return visible[gl_InstanceIndex]; }
+#else
+uint instance_index() { return gl_InstanceIndex; }
+#endif
+
+layout (location = 0) out vec3 out_color;
+layout (location = 1) out vec2 out_uv;
+// only read by the bindless fragment shader.
+layout (location = 2) flat out uint out_texture;
+
+void main() {
+	const Instance instance = instances[instance_index()];
+	// model matrix expanded here: translate * rotate * scale.
+	const float angle = radians(instance.rotation);
+	const float c = cos(angle);
+	const float s = sin(angle);
+	const mat2 mat_rs = mat2(c, s, -s, c) * mat2(instance.scale.x, 0.0, 0.0, instance.scale.y);
+	const vec2 world_pos = instance.position + mat_rs * a_pos;
+
+	out_color = a_color * unpackUnorm4x8(instance.color).rgb;
+	out_uv = a_uv;
+	out_texture = instance.texture;
+	gl_Position = mat_vp * vec4(world_pos, 0.0, 1.0);
+}
@@ -5,17 +5,18 @@
 
 auto lvk::get_suitable_gpu(vk::Instance const instance,
 						   vk::SurfaceKHR const surface) -> Gpu {
-	auto const supports_swapchain = [](Gpu const& gpu) {
-		static constexpr std::string_view name_v =
-			VK_KHR_SWAPCHAIN_EXTENSION_NAME;
-		static constexpr auto is_swapchain =
-			[](vk::ExtensionProperties const& properties) {
-				return properties.extensionName.data() == name_v;
-			};
+	auto const supports_extension = [](Gpu const& gpu,
+									   std::string_view const name) {
+		auto const matches = [name](vk::ExtensionProperties const& properties) {
+			return properties.extensionName.data() == name;
+		};
 		auto const properties = gpu.device.enumerateDeviceExtensionProperties();
-		auto const it = std::ranges::find_if(properties, is_swapchain);
+		auto const it = std::ranges::find_if(properties, matches);
 		return it != properties.end();
 	};
+	auto const supports_swapchain = [&](Gpu const& gpu) {
+		return supports_extension(gpu, VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+	};
 
 	auto const set_queue_family = [](Gpu& out_gpu) {
 		static constexpr auto queue_flags_v =
@@ -30,19 +31,94 @@ auto lvk::get_suitable_gpu(vk::Instance const instance,
 		return false;
 	};
 
+	auto const set_transfer_queue_family = [](Gpu& out_gpu) {
+		static constexpr auto other_flags_v =
+			vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute;
+		for (auto const [index, family] :
+			 std::views::enumerate(out_gpu.device.getQueueFamilyProperties())) {
+			if ((family.queueFlags & vk::QueueFlagBits::eTransfer) &&
+				!(family.queueFlags & other_flags_v)) {
+				out_gpu.transfer_queue_family =
+					static_cast<std::uint32_t>(index);
+				return;
+			}
+		}
+	};
+
+	// partially bound, update after bind, non-uniformly indexed arrays of
+	// combined image samplers.
+	auto const set_max_bindless_textures = [](Gpu& out_gpu) {
+		auto const features = out_gpu.device.getFeatures2<
+			vk::PhysicalDeviceFeatures2,
+			vk::PhysicalDeviceDescriptorIndexingFeatures>();
+		auto const& indexing =
+			features.get<vk::PhysicalDeviceDescriptorIndexingFeatures>();
+		if (!indexing.runtimeDescriptorArray ||
+			!indexing.descriptorBindingPartiallyBound ||
+			!indexing.descriptorBindingSampledImageUpdateAfterBind ||
+			!indexing.shaderSampledImageArrayNonUniformIndexing) {
+			return;
+		}
+		auto const properties = out_gpu.device.getProperties2<
+			vk::PhysicalDeviceProperties2,
+			vk::PhysicalDeviceDescriptorIndexingProperties>();
+		auto const& limits =
+			properties.get<vk::PhysicalDeviceDescriptorIndexingProperties>();
+		// combined image samplers count against both limits.
+		out_gpu.max_bindless_textures = std::min({
+			limits.maxPerStageDescriptorUpdateAfterBindSamplers,
+			limits.maxPerStageDescriptorUpdateAfterBindSampledImages,
+			limits.maxDescriptorSetUpdateAfterBindSamplers,
+			limits.maxDescriptorSetUpdateAfterBindSampledImages,
+		});
+	};
+
+	auto const set_descriptor_buffer = [&](Gpu& out_gpu) {
+		if (!supports_extension(out_gpu,
+								VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME)) {
+			return;
+		}
+		auto const features = out_gpu.device.getFeatures2<
+			vk::PhysicalDeviceFeatures2,
+			vk::PhysicalDeviceBufferDeviceAddressFeatures,
+			vk::PhysicalDeviceDescriptorBufferFeaturesEXT>();
+		if (!features.get<vk::PhysicalDeviceBufferDeviceAddressFeatures>()
+				 .bufferDeviceAddress ||
+			!features.get<vk::PhysicalDeviceDescriptorBufferFeaturesEXT>()
+				 .descriptorBuffer) {
+			return;
+		}
+		auto const properties = out_gpu.device.getProperties2<
+			vk::PhysicalDeviceProperties2,
+			vk::PhysicalDeviceDescriptorBufferPropertiesEXT>();
+		auto ret =
+			properties.get<vk::PhysicalDeviceDescriptorBufferPropertiesEXT>();
+		// do not keep a pointer into the (temporary) chain.
+		ret.setPNext(nullptr);
+		out_gpu.descriptor_buffer = ret;
+	};
+
 	auto const can_present = [surface](Gpu const& gpu) {
 		return gpu.device.getSurfaceSupportKHR(gpu.queue_family, surface) ==
 			   vk::True;
 	};
 
+	// no surface => headless: presentation support is irrelevant.
+	auto const headless = !surface;
+
 	auto fallback = Gpu{};
 	for (auto const& device : instance.enumeratePhysicalDevices()) {
 		auto gpu = Gpu{.device = device, .properties = device.getProperties()};
 		if (gpu.properties.apiVersion < vk_version_v) { continue; }
-		if (!supports_swapchain(gpu)) { continue; }
+		if (!headless && !supports_swapchain(gpu)) { continue; }
 		if (!set_queue_family(gpu)) { continue; }
-		if (!can_present(gpu)) { continue; }
+		if (!headless && !can_present(gpu)) { continue; }
+		set_transfer_queue_family(gpu);
+		gpu.push_descriptors =
+			supports_extension(gpu, VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME);
 		gpu.features = gpu.device.getFeatures();
+		set_max_bindless_textures(gpu);
+		set_descriptor_buffer(gpu);
 		if (gpu.properties.deviceType == vk::PhysicalDeviceType::eDiscreteGpu) {
 			return gpu;
 		}
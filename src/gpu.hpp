@@ -1,5 +1,6 @@
 #pragma once
 #include <vulkan/vulkan.hpp>
+#include <optional>
 
 namespace lvk {
 constexpr auto vk_version_v = VK_MAKE_VERSION(1, 3, 0);
@@ -9,8 +10,20 @@ struct Gpu {
 	vk::PhysicalDeviceProperties properties{};
 	vk::PhysicalDeviceFeatures features{};
 	std::uint32_t queue_family{};
+	// family that supports transfer but neither graphics nor compute, if any.
+	std::optional<std::uint32_t> transfer_queue_family{};
+	// VK_KHR_push_descriptor is supported.
+	bool push_descriptors{};
+	// number of textures a bindless (descriptor indexing) array can hold,
+	// 0 if the required descriptor indexing features are not supported.
+	std::uint32_t max_bindless_textures{};
+	// properties of VK_EXT_descriptor_buffer, if it (and buffer device
+	// address) is supported.
+	std::optional<vk::PhysicalDeviceDescriptorBufferPropertiesEXT>
+		descriptor_buffer{};
 };
 
+// pass a null surface to select a GPU for headless (offscreen) rendering.
 [[nodiscard]] auto get_suitable_gpu(vk::Instance instance,
 									vk::SurfaceKHR surface) -> Gpu;
 } // namespace lvk
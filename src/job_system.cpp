@@ -0,0 +1,182 @@
+#include <job_system.hpp>
+#include <utility>
+
+namespace lvk {
+namespace {
+// queue owned by the current thread, if it is a worker.
+thread_local JobSystem const* t_system{};
+thread_local std::size_t t_queue_index{};
+// whether the current thread is running a background job.
+thread_local bool t_background{};
+} // namespace
+
+JobSystem::JobSystem(std::size_t const worker_count) {
+	// the last queue receives jobs submitted from non-worker threads.
+	m_queues.resize(worker_count + 1);
+	for (auto& queue : m_queues) { queue = std::make_unique<Queue>(); }
+
+	m_workers.reserve(worker_count);
+	for (std::size_t i = 0; i < worker_count; ++i) {
+		m_workers.emplace_back([this, i] { worker_loop(i); });
+	}
+}
+
+JobSystem::~JobSystem() {
+	{
+		auto lock = std::scoped_lock{m_sleep_mutex};
+		m_stop = true;
+	}
+	m_wake.notify_all();
+	m_workers.clear();
+}
+
+auto JobSystem::submit(Task task, std::span<JobHandle const> dependencies)
+	-> JobHandle {
+	return submit(std::move(task), dependencies, t_background);
+}
+
+auto JobSystem::submit_background(Task task,
+								  std::span<JobHandle const> dependencies)
+	-> JobHandle {
+	return submit(std::move(task), dependencies, true);
+}
+
+auto JobSystem::submit(Task task, std::span<JobHandle const> dependencies,
+					   bool const background) -> JobHandle {
+	auto job = std::make_shared<JobHandle::Job>();
+	job->task = std::move(task);
+	job->background = background;
+	job->pending.fetch_add(static_cast<std::uint32_t>(dependencies.size()));
+	for (auto const& dependency : dependencies) {
+		auto const& dep = dependency.m_job;
+		if (!dep) {
+			job->pending.fetch_sub(1);
+			continue;
+		}
+		auto lock = std::scoped_lock{dep->mutex};
+		if (dep->finished) {
+			job->pending.fetch_sub(1);
+		} else {
+			dep->dependents.push_back(job);
+		}
+	}
+	// release the submission reference: enqueue if nothing is pending.
+	if (job->pending.fetch_sub(1) == 1) { enqueue(job); }
+	return JobHandle{std::move(job)};
+}
+
+void JobSystem::wait(JobHandle const& handle) {
+	if (!handle) { return; }
+	auto& job = *handle.m_job;
+	auto const first_queue =
+		t_system == this ? t_queue_index : m_queues.size() - 1;
+	// other threads' waits must not be held up by background jobs.
+	auto const allow_background = t_background || job.background;
+	while (!job.done.load(std::memory_order_acquire)) {
+		// help: run other jobs while this one is pending or running.
+		if (run_one(first_queue, allow_background)) { continue; }
+		// nothing to help with: the job is running on another thread, or
+		// waiting on dependencies that are.
+		job.done.wait(false, std::memory_order_acquire);
+	}
+	if (job.exception) { std::rethrow_exception(job.exception); }
+}
+
+void JobSystem::enqueue(std::shared_ptr<JobHandle::Job> job) {
+	// workers push to their own queue, other threads to the shared one.
+	auto const queue_index =
+		t_system == this ? t_queue_index : m_queues.size() - 1;
+	auto& queue = job->background ? m_background : *m_queues.at(queue_index);
+	{
+		auto lock = std::scoped_lock{queue.mutex};
+		queue.jobs.push_back(std::move(job));
+	}
+	{
+		// lock to avoid a lost wakeup between a worker's check and its wait.
+		auto lock = std::scoped_lock{m_sleep_mutex};
+		m_queued.fetch_add(1);
+	}
+	m_wake.notify_one();
+}
+
+void JobSystem::finish(JobHandle::Job& job) {
+	auto dependents = std::vector<std::shared_ptr<JobHandle::Job>>{};
+	{
+		auto lock = std::scoped_lock{job.mutex};
+		job.finished = true;
+		std::swap(dependents, job.dependents);
+	}
+	for (auto& dependent : dependents) {
+		if (dependent->pending.fetch_sub(1) == 1) {
+			enqueue(std::move(dependent));
+		}
+	}
+	job.done.store(true, std::memory_order_release);
+	job.done.notify_all();
+}
+
+auto JobSystem::pop(std::size_t const queue_index)
+	-> std::shared_ptr<JobHandle::Job> {
+	auto& queue = *m_queues.at(queue_index);
+	auto lock = std::scoped_lock{queue.mutex};
+	if (queue.jobs.empty()) { return {}; }
+	// LIFO for the owner: most recently pushed jobs are hottest in cache.
+	auto ret = std::move(queue.jobs.back());
+	queue.jobs.pop_back();
+	m_queued.fetch_sub(1);
+	return ret;
+}
+
+auto JobSystem::steal(std::size_t const first_queue)
+	-> std::shared_ptr<JobHandle::Job> {
+	for (std::size_t i = 1; i < m_queues.size(); ++i) {
+		auto& queue = *m_queues.at((first_queue + i) % m_queues.size());
+		auto lock = std::scoped_lock{queue.mutex};
+		if (queue.jobs.empty()) { continue; }
+		// FIFO for thieves: oldest jobs tend to be the largest.
+		auto ret = std::move(queue.jobs.front());
+		queue.jobs.pop_front();
+		m_queued.fetch_sub(1);
+		return ret;
+	}
+	return {};
+}
+
+auto JobSystem::pop_background() -> std::shared_ptr<JobHandle::Job> {
+	auto lock = std::scoped_lock{m_background.mutex};
+	if (m_background.jobs.empty()) { return {}; }
+	// FIFO: in order of submission.
+	auto ret = std::move(m_background.jobs.front());
+	m_background.jobs.pop_front();
+	m_queued.fetch_sub(1);
+	return ret;
+}
+
+auto JobSystem::run_one(std::size_t const first_queue,
+						bool const allow_background) -> bool {
+	auto job = pop(first_queue);
+	if (!job) { job = steal(first_queue); }
+	if (!job && allow_background) { job = pop_background(); }
+	if (!job) { return false; }
+	auto const background = std::exchange(t_background, job->background);
+	try {
+		job->task();
+	} catch (...) { job->exception = std::current_exception(); }
+	t_background = background;
+	// release captured state before signaling completion.
+	job->task = {};
+	finish(*job);
+	return true;
+}
+
+void JobSystem::worker_loop(std::size_t const worker_index) {
+	t_system = this;
+	t_queue_index = worker_index;
+	while (true) {
+		if (run_one(worker_index, true)) { continue; }
+		auto lock = std::unique_lock{m_sleep_mutex};
+		m_wake.wait(lock, [this] { return m_stop || m_queued > 0; });
+		if (m_stop) { return; }
+	}
+}
+} // namespace lvk
@@ -0,0 +1,192 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace lvk {
+class JobSystem;
+
+// Shared handle to a submitted job, used to wait on it or to declare it as a
+// dependency of other jobs.
+class JobHandle {
+  public:
+	JobHandle() = default;
+
+	// whether the job (and its task) has finished, false if null.
+	[[nodiscard]] auto is_done() const -> bool;
+
+	explicit operator bool() const { return m_job != nullptr; }
+
+  private:
+	struct Job;
+
+	explicit JobHandle(std::shared_ptr<Job> job) : m_job(std::move(job)) {}
+
+	std::shared_ptr<Job> m_job{};
+
+	friend class JobSystem;
+};
+
+// Work-stealing task scheduler: each worker owns a deque, pops its own jobs
+// LIFO and steals from others FIFO when empty. Threads that wait on a job
+// (including the main thread) run queued jobs instead of blocking.
+// Background jobs have a queue of their own, serviced by workers once the
+// others are empty: waiting threads only run them if they wait on a
+// background job (or from one), so they never delay frames.
+// Tasks must not submit jobs that they then wait on from a non-worker thread.
+class JobSystem {
+  public:
+	using Task = std::function<void()>;
+
+	// worker_count may be 0: jobs then only run on waiting threads.
+	explicit JobSystem(std::size_t worker_count);
+
+	JobSystem(JobSystem const&) = delete;
+	JobSystem(JobSystem&&) = delete;
+	auto operator=(JobSystem const&) = delete;
+	auto operator=(JobSystem&&) = delete;
+
+	~JobSystem();
+
+	[[nodiscard]] auto worker_count() const -> std::size_t {
+		return m_workers.size();
+	}
+
+	// task runs once all dependencies have finished. Jobs submitted from a
+	// background job are background jobs too.
+	auto submit(Task task, std::span<JobHandle const> dependencies = {})
+		-> JobHandle;
+	// submits a background job: for long running work (eg streaming) that
+	// threads waiting on other jobs must not pick up.
+	auto submit_background(Task task,
+						   std::span<JobHandle const> dependencies = {})
+		-> JobHandle;
+
+	// runs queued jobs until job is done, rethrows if its task threw.
+	void wait(JobHandle const& job);
+
+	// invokes func(begin, end) over [0, count) split into chunks of at most
+	// grain elements, and waits for all of them (rethrowing the first
+	// exception). Runs inline if count fits in a single chunk.
+	template <typename Func>
+	void parallel_for(std::size_t count, std::size_t grain, Func const& func);
+
+  private:
+	struct Queue {
+		std::mutex mutex{};
+		std::deque<std::shared_ptr<JobHandle::Job>> jobs{};
+	};
+
+	auto submit(Task task, std::span<JobHandle const> dependencies,
+				bool background) -> JobHandle;
+	void enqueue(std::shared_ptr<JobHandle::Job> job);
+	void finish(JobHandle::Job& job);
+	[[nodiscard]] auto pop(std::size_t queue_index)
+		-> std::shared_ptr<JobHandle::Job>;
+	[[nodiscard]] auto steal(std::size_t first_queue)
+		-> std::shared_ptr<JobHandle::Job>;
+	[[nodiscard]] auto pop_background() -> std::shared_ptr<JobHandle::Job>;
+	// runs one queued job if available, returns false if none were found.
+	auto run_one(std::size_t first_queue, bool allow_background) -> bool;
+	void worker_loop(std::size_t worker_index);
+
+	// one queue per worker, plus one for external (non-worker) submissions.
+	std::vector<std::unique_ptr<Queue>> m_queues{};
+	Queue m_background{};
+	std::atomic<std::size_t> m_queued{};
+	std::atomic<bool> m_stop{};
+
+	std::mutex m_sleep_mutex{};
+	std::condition_variable m_wake{};
+
+	std::vector<std::jthread> m_workers{};
+};
+
+// Waits for its jobs when destroyed, including while unwinding: their tasks
+// may reference state that is about to be destroyed. wait() rethrows a
+// job's exception, the destructor does not.
+class ScopedJobs {
+  public:
+	explicit ScopedJobs(JobSystem& jobs) : m_jobs(&jobs) {}
+
+	ScopedJobs(ScopedJobs const&) = delete;
+	ScopedJobs(ScopedJobs&&) = delete;
+	auto operator=(ScopedJobs const&) = delete;
+	auto operator=(ScopedJobs&&) = delete;
+
+	~ScopedJobs() {
+		for (auto const& job : m_handles) {
+			try {
+				m_jobs->wait(job);
+			} catch (...) {
+				// either unwinding already, or rethrown by wait().
+			}
+		}
+	}
+
+	void add(JobHandle job) { m_handles.push_back(std::move(job)); }
+
+	// waits for all jobs added so far.
+	void wait() {
+		for (auto const& job : m_handles) { m_jobs->wait(job); }
+		m_handles.clear();
+	}
+
+  private:
+	JobSystem* m_jobs{};
+	std::vector<JobHandle> m_handles{};
+};
+
+struct JobHandle::Job {
+	JobSystem::Task task{};
+	// dependencies not yet finished, plus one held during submission.
+	std::atomic<std::uint32_t> pending{1};
+	std::atomic<bool> done{};
+	std::exception_ptr exception{};
+	bool background{};
+
+	std::mutex mutex{};
+	bool finished{}; // guarded by mutex, set before dependents are released.
+	std::vector<std::shared_ptr<Job>> dependents{};
+};
+
+inline auto JobHandle::is_done() const -> bool {
+	return m_job && m_job->done.load(std::memory_order_acquire);
+}
+
+template <typename Func>
+void JobSystem::parallel_for(std::size_t const count, std::size_t grain,
+							 Func const& func) {
+	if (count == 0) { return; }
+	grain = std::max(grain, std::size_t{1});
+	if (count <= grain || m_workers.empty()) {
+		func(std::size_t{0}, count);
+		return;
+	}
+	auto jobs = std::vector<JobHandle>{};
+	jobs.reserve((count + grain - 1) / grain);
+	for (std::size_t begin = 0; begin < count; begin += grain) {
+		auto const end = std::min(begin + grain, count);
+		jobs.push_back(submit([&func, begin, end] { func(begin, end); }));
+	}
+	// wait for every chunk before rethrowing: they all reference func.
+	auto exception = std::exception_ptr{};
+	for (auto const& job : jobs) {
+		try {
+			wait(job);
+		} catch (...) {
+			if (!exception) { exception = std::current_exception(); }
+		}
+	}
+	if (exception) { std::rethrow_exception(exception); }
+}
+} // namespace lvk
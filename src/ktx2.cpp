@@ -0,0 +1,151 @@
+#include <ktx2.hpp>
+#include <mip_chain.hpp>
+#include <vulkan/vulkan_format_traits.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <print>
+#include <string_view>
+
+namespace lvk {
+namespace {
+constexpr auto identifier_v =
+	std::array<std::uint8_t, 12>{0xab, 0x4b, 0x54, 0x58, 0x20, 0x32,
+								 0x30, 0xbb, 0x0d, 0x0a, 0x1a, 0x0a};
+
+// header and index after the identifier, up to the supercompression global
+// data (unused).
+struct Header {
+	std::uint32_t vk_format;
+	std::uint32_t type_size;
+	std::uint32_t pixel_width;
+	std::uint32_t pixel_height;
+	std::uint32_t pixel_depth;
+	std::uint32_t layer_count;
+	std::uint32_t face_count;
+	std::uint32_t level_count;
+	std::uint32_t supercompression_scheme;
+	std::uint32_t dfd_byte_offset;
+	std::uint32_t dfd_byte_length;
+	std::uint32_t kvd_byte_offset;
+	std::uint32_t kvd_byte_length;
+};
+static_assert(sizeof(Header) == 52);
+
+struct LevelIndex {
+	std::uint64_t byte_offset;
+	std::uint64_t byte_length;
+	std::uint64_t uncompressed_byte_length;
+};
+static_assert(sizeof(LevelIndex) == 24);
+
+// KTX2 is little endian, like every platform this runs on.
+template <typename Type>
+[[nodiscard]] auto read(std::span<std::byte const> bytes,
+						std::size_t const offset) -> Type {
+	auto ret = Type{};
+	std::memcpy(&ret, bytes.subspan(offset, sizeof(Type)).data(),
+				sizeof(Type));
+	return ret;
+}
+
+// minimum bytes of a level of format, 0 if format is unknown.
+[[nodiscard]] auto get_level_size(vk::Format const format,
+								  vk::Extent2D const extent) -> std::uint64_t {
+	auto const block_size = vk::blockSize(format);
+	auto const block_extent = vk::blockExtent(format);
+	if (block_size == 0 || block_extent[0] == 0 || block_extent[1] == 0) {
+		return 0;
+	}
+	auto const blocks_x =
+		(extent.width + block_extent[0] - 1) / block_extent[0];
+	auto const blocks_y =
+		(extent.height + block_extent[1] - 1) / block_extent[1];
+	return std::uint64_t{blocks_x} * blocks_y * block_size;
+}
+
+[[nodiscard]] auto invalid(std::string_view const reason)
+	-> std::optional<Ktx2Image> {
+	std::println(stderr, "Invalid KTX2: {}", reason);
+	return {};
+}
+} // namespace
+
+auto parse_ktx2(std::span<std::byte const> bytes)
+	-> std::optional<Ktx2Image> {
+	static constexpr auto header_offset_v = identifier_v.size();
+	static constexpr auto levels_offset_v = 80uz;
+	if (bytes.size() < levels_offset_v ||
+		std::memcmp(bytes.data(), identifier_v.data(), identifier_v.size()) !=
+			0) {
+		return invalid("not a KTX2 container");
+	}
+
+	auto const header = read<Header>(bytes, header_offset_v);
+	if (header.vk_format == VK_FORMAT_UNDEFINED) {
+		return invalid("Basis Universal payloads are not supported");
+	}
+	if (header.supercompression_scheme != 0) {
+		return invalid("supercompression is not supported");
+	}
+	if (header.pixel_width == 0 || header.pixel_height == 0 ||
+		header.pixel_depth != 0) {
+		return invalid("not a 2D image");
+	}
+	if (header.layer_count > 1 || header.face_count != 1) {
+		return invalid("arrays and cube maps are not supported");
+	}
+	auto const format = static_cast<vk::Format>(header.vk_format);
+	auto const extent = vk::Extent2D{header.pixel_width, header.pixel_height};
+	if (get_level_size(format, extent) == 0) {
+		return invalid("unknown format");
+	}
+	if (header.level_count > get_mip_levels(extent)) {
+		return invalid("more levels than a full mip chain");
+	}
+
+	// 0 levels: the loader is expected to generate them, only the first is
+	// stored.
+	auto const level_count = std::max(header.level_count, 1u);
+	if (bytes.size() < levels_offset_v + level_count * sizeof(LevelIndex)) {
+		return invalid("truncated level index");
+	}
+	auto levels = std::vector<LevelIndex>{};
+	levels.reserve(level_count);
+	for (auto level = 0uz; level < level_count; ++level) {
+		auto const offset = levels_offset_v + level * sizeof(LevelIndex);
+		auto const& index =
+			levels.emplace_back(read<LevelIndex>(bytes, offset));
+		if (index.byte_offset > bytes.size() ||
+			index.byte_length > bytes.size() - index.byte_offset) {
+			return invalid("level out of bounds");
+		}
+		auto const level_extent =
+			get_mip_extent(extent, static_cast<std::uint32_t>(level));
+		if (index.byte_length < get_level_size(format, level_extent)) {
+			return invalid("level is smaller than its extent");
+		}
+	}
+
+	// levels are stored smallest first: reference the range covering all.
+	auto begin = std::uint64_t{bytes.size()};
+	auto end = std::uint64_t{};
+	for (auto const& index : levels) {
+		begin = std::min(begin, index.byte_offset);
+		end = std::max(end, index.byte_offset + index.byte_length);
+	}
+	auto ret = Ktx2Image{
+		.format = format,
+		.extent = extent,
+		.bytes = bytes.subspan(begin, end - begin),
+	};
+	ret.level_offsets.reserve(level_count);
+	ret.level_sizes.reserve(level_count);
+	for (auto const& index : levels) {
+		ret.level_offsets.push_back(index.byte_offset - begin);
+		ret.level_sizes.push_back(index.byte_length);
+	}
+	return ret;
+}
+} // namespace lvk
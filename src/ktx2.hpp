@@ -0,0 +1,31 @@
+#pragma once
+#include <vulkan/vulkan.hpp>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace lvk {
+// mip levels of a KTX2 container, referencing its bytes.
+struct Ktx2Image {
+	vk::Format format{};
+	vk::Extent2D extent{};
+	// all levels, level i (largest first) at level_offsets[i].
+	std::span<std::byte const> bytes{};
+	std::vector<vk::DeviceSize> level_offsets{};
+	std::vector<vk::DeviceSize> level_sizes{};
+
+	[[nodiscard]] auto get_level(std::size_t const level) const
+		-> std::span<std::byte const> {
+		return bytes.subspan(level_offsets.at(level), level_sizes.at(level));
+	}
+};
+
+// parses a 2D KTX2 container (single layer and face) without
+// supercompression, bytes must outlive the returned image. Levels are
+// validated against the extent: at most a full mip chain, each holding at
+// least the blocks of its extent.
+// prints an error and returns nullopt if bytes cannot be used.
+[[nodiscard]] auto parse_ktx2(std::span<std::byte const> bytes)
+	-> std::optional<Ktx2Image>;
+} // namespace lvk
@@ -1,20 +1,94 @@
 #include <app.hpp>
+#include <charconv>
 #include <exception>
+#include <format>
 #include <print>
 #include <span>
+#include <stdexcept>
+#include <string_view>
+
+namespace {
+// returns the argument following a flag, throws if missing.
+auto get_value(std::span<char*>& args) -> std::string_view {
+	auto const flag = std::string_view{args.front()};
+	if (args.size() < 2) {
+		throw std::runtime_error{std::format("Missing value for '{}'", flag)};
+	}
+	args = args.subspan(1);
+	return args.front();
+}
+
+// parses the argument following a flag, throws if missing or invalid.
+template <typename Type>
+auto parse_value(std::span<char*>& args) -> Type {
+	auto const flag = std::string_view{args.front()};
+	auto const value = get_value(args);
+	auto ret = Type{};
+	auto const [ptr, ec] =
+		std::from_chars(value.data(), value.data() + value.size(), ret);
+	if (ec != std::errc{} || ptr != value.data() + value.size()) {
+		throw std::runtime_error{
+			std::format("Invalid value for '{}': '{}'", flag, value)};
+	}
+	return ret;
+}
+} // namespace
 
 auto main(int argc, char** argv) -> int {
 	try {
+		auto options = lvk::App::Options{};
 		// skip the first argument.
 		auto args = std::span{argv, static_cast<std::size_t>(argc)}.subspan(1);
 		while (!args.empty()) {
 			auto const arg = std::string_view{args.front()};
 			if (arg == "-x" || arg == "--force-x11") {
 				glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_X11);
+			} else if (arg == "--headless") {
+				options.headless = true;
+			} else if (arg == "--frames") {
+				options.frame_count = parse_value<std::uint64_t>(args);
+			} else if (arg == "--width") {
+				options.extent.x = parse_value<int>(args);
+			} else if (arg == "--height") {
+				options.extent.y = parse_value<int>(args);
+			} else if (arg == "--timeline") {
+				options.timeline_sync = true;
+			} else if (arg == "--frames-in-flight") {
+				options.frames_in_flight = parse_value<std::size_t>(args);
+			} else if (arg == "--workers") {
+				options.worker_threads = parse_value<std::size_t>(args);
+			} else if (arg == "--record-threads") {
+				options.record_threads = parse_value<std::size_t>(args);
+			} else if (arg == "--draws") {
+				options.draw_calls = parse_value<std::uint32_t>(args);
+			} else if (arg == "--instances") {
+				options.instance_count = parse_value<std::size_t>(args);
+			} else if (arg == "--packed-instances") {
+				options.instance_format = lvk::InstanceFormat::Packed;
+			} else if (arg == "--gpu-cull") {
+				options.gpu_culling = true;
+			} else if (arg == "--meshes") {
+				options.mesh_count = parse_value<std::size_t>(args);
+			} else if (arg == "--single-queue") {
+				options.transfer_queue = false;
+			} else if (arg == "--dynamic-descriptors") {
+				options.dynamic_descriptors = true;
+			} else if (arg == "--no-push-descriptors") {
+				options.push_descriptors = false;
+			} else if (arg == "--bindless") {
+				options.bindless = true;
+			} else if (arg == "--descriptor-buffer") {
+				options.descriptor_buffer = true;
+			} else if (arg == "--texture") {
+				options.texture = get_value(args);
+			} else if (arg == "--perf-csv") {
+				options.perf_csv = get_value(args);
+			} else if (arg == "--trace") {
+				options.trace_json = get_value(args);
 			}
 			args = args.subspan(1);
 		}
-		lvk::App{}.run();
+		lvk::App{options}.run();
 	} catch (std::exception const& e) {
 		std::println(stderr, "PANIC: {}", e.what());
 		return EXIT_FAILURE;
@@ -0,0 +1,71 @@
+#include <mesh_registry.hpp>
+#include <stdexcept>
+
+namespace lvk {
+namespace {
+[[nodiscard]] auto create_arena(MeshRegistryCreateInfo const& create_info,
+								vk::BufferUsageFlags const usage,
+								vk::DeviceSize const element_size,
+								std::size_t const capacity) -> GeometryArena {
+	return GeometryArena{GeometryArena::CreateInfo{
+		.device = create_info.device,
+		.allocator = create_info.allocator,
+		.usage = usage,
+		.queue_family = create_info.queue_family,
+		.command_blocks = create_info.command_blocks,
+		.staging = create_info.staging,
+		.element_size = element_size,
+		.capacity = capacity,
+	}};
+}
+} // namespace
+
+MeshRegistry::MeshRegistry(CreateInfo const& create_info)
+	: m_vertices(create_arena(create_info,
+							  vk::BufferUsageFlagBits::eVertexBuffer,
+							  sizeof(Vertex), create_info.vertex_capacity)),
+	  m_indices(create_arena(create_info, vk::BufferUsageFlagBits::eIndexBuffer,
+							 sizeof(std::uint32_t),
+							 create_info.index_capacity)) {}
+
+auto MeshRegistry::add(MeshGeometry const& geometry) -> Id {
+	auto const mesh = Mesh{
+		.vertices = m_vertices.upload(std::as_bytes(geometry.vertices)),
+		.indices = m_indices.upload(std::as_bytes(geometry.indices)),
+	};
+	m_meshes.emplace_back(mesh);
+	return m_meshes.size() - 1;
+}
+
+void MeshRegistry::remove(Id const id) {
+	auto& mesh = m_meshes.at(id);
+	if (!mesh) { return; }
+	m_vertices.release(mesh->vertices);
+	m_indices.release(mesh->indices);
+	mesh.reset();
+}
+
+auto MeshRegistry::get_mesh(Id const id) const -> MeshHandle {
+	auto const& mesh = m_meshes.at(id);
+	if (!mesh) { throw std::out_of_range{"Mesh has been removed"}; }
+	auto const vertices = m_vertices.get_range(mesh->vertices);
+	auto const indices = m_indices.get_range(mesh->indices);
+	return MeshHandle{
+		.first_vertex = static_cast<std::int32_t>(vertices.first),
+		.first_index = static_cast<std::uint32_t>(indices.first),
+		.index_count = static_cast<std::uint32_t>(indices.count),
+	};
+}
+
+void MeshRegistry::defragment() {
+	m_vertices.defragment();
+	m_indices.defragment();
+}
+
+void MeshRegistry::bind(vk::CommandBuffer const command_buffer) const {
+	command_buffer.bindVertexBuffers(0, m_vertices.get_buffer(),
+									 vk::DeviceSize{});
+	command_buffer.bindIndexBuffer(m_indices.get_buffer(), 0,
+								   vk::IndexType::eUint32);
+}
+} // namespace lvk
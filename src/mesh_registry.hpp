@@ -0,0 +1,88 @@
+#pragma once
+#include <geometry_arena.hpp>
+#include <vertex.hpp>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace lvk {
+struct MeshGeometry {
+	std::span<Vertex const> vertices{};
+	std::span<std::uint32_t const> indices{};
+};
+
+// location of a mesh in the registry's shared buffers.
+struct MeshHandle {
+	std::int32_t first_vertex{};
+	std::uint32_t first_index{};
+	std::uint32_t index_count{};
+
+	// draws instance_count instances of this mesh.
+	[[nodiscard]] auto draw_command(std::uint32_t const instance_count,
+									std::uint32_t const first_instance) const
+		-> vk::DrawIndexedIndirectCommand {
+		return vk::DrawIndexedIndirectCommand{index_count, instance_count,
+											  first_index, first_vertex,
+											  first_instance};
+	}
+};
+
+struct MeshRegistryCreateInfo {
+	vk::Device device;
+	VmaAllocator allocator;
+	std::uint32_t queue_family;
+	CommandBlockPool* command_blocks;
+	StagingRing* staging;
+	// initial capacities, arenas grow as needed.
+	std::size_t vertex_capacity{1 << 16};
+	std::size_t index_capacity{1 << 18};
+};
+
+// Packs meshes into two geometry arenas (one vertex and one index buffer).
+// Indices are relative to each mesh's first vertex, so any number of meshes
+// can be drawn with a single bind and indirect draw.
+class MeshRegistry {
+  public:
+	using CreateInfo = MeshRegistryCreateInfo;
+	// stable identifier of a mesh, valid until removed.
+	using Id = std::size_t;
+
+	explicit MeshRegistry(CreateInfo const& create_info);
+
+	// uploads geometry to the arenas.
+	[[nodiscard]] auto add(MeshGeometry const& geometry) -> Id;
+	void remove(Id id);
+
+	// number of ids ever handed out (including removed ones).
+	[[nodiscard]] auto id_count() const -> std::size_t {
+		return m_meshes.size();
+	}
+	// handles change when arenas grow or are defragmented: query them again
+	// after adding meshes or calling defragment().
+	[[nodiscard]] auto get_mesh(Id id) const -> MeshHandle;
+
+	// compacts both arenas.
+	void defragment();
+
+	[[nodiscard]] auto vertex_stats() const -> GeometryArenaStats {
+		return m_vertices.get_stats();
+	}
+	[[nodiscard]] auto index_stats() const -> GeometryArenaStats {
+		return m_indices.get_stats();
+	}
+
+	// binds the shared vertex (binding 0) and index buffers.
+	void bind(vk::CommandBuffer command_buffer) const;
+
+  private:
+	struct Mesh {
+		GeometryArena::Id vertices{};
+		GeometryArena::Id indices{};
+	};
+
+	GeometryArena m_vertices;
+	GeometryArena m_indices;
+	std::vector<std::optional<Mesh>> m_meshes{};
+};
+} // namespace lvk
@@ -0,0 +1,254 @@
+#include <mip_chain.hpp>
+#include <trace.hpp>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+	(defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LVK_MIP_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define LVK_MIP_NEON
+#endif
+
+namespace lvk {
+namespace {
+// bytes per texel.
+constexpr auto channels_v = 4uz;
+
+using Texel = std::array<float, channels_v>;
+
+[[nodiscard]] auto srgb_to_linear(double const c) -> float {
+	if (c <= 0.04045) { return static_cast<float>(c / 12.92); }
+	return static_cast<float>(std::pow((c + 0.055) / 1.055, 2.4));
+}
+
+// sRGB formats are filtered in linear space (like blits of them are): RGB
+// is decoded before averaging and encoded after, alpha is linear.
+struct SrgbTables {
+	std::array<float, 256> to_linear{};
+	// linear value halfway between consecutive codes (in encoded space):
+	// encoding rounds to the nearest code.
+	std::array<float, 255> thresholds{};
+	// code to start searching thresholds from, for linear values bucketed
+	// by the table size. Taken from the previous bucket so it never
+	// overshoots, a few steps up reach the nearest code.
+	std::array<std::uint8_t, 4096> search_start{};
+};
+
+[[nodiscard]] auto get_srgb_tables() -> SrgbTables const& {
+	static auto const ret = [] {
+		auto ret = SrgbTables{};
+		for (auto i = 0uz; i < ret.to_linear.size(); ++i) {
+			ret.to_linear.at(i) = srgb_to_linear(double(i) / 255.0);
+		}
+		for (auto i = 0uz; i < ret.thresholds.size(); ++i) {
+			ret.thresholds.at(i) = srgb_to_linear((double(i) + 0.5) / 255.0);
+		}
+		auto const max_bucket = float(ret.search_start.size() - 1);
+		for (auto i = 1uz; i < ret.search_start.size(); ++i) {
+			auto const linear = float(i - 1) / max_bucket;
+			auto const it = std::ranges::upper_bound(ret.thresholds, linear);
+			ret.search_start.at(i) =
+				static_cast<std::uint8_t>(it - ret.thresholds.begin());
+		}
+		return ret;
+	}();
+	return ret;
+}
+
+void decode_row(SrgbTables const& tables, std::uint8_t const* src,
+				std::span<Texel> dst) {
+	for (auto& texel : dst) {
+		texel = Texel{tables.to_linear[src[0]], tables.to_linear[src[1]],
+					  tables.to_linear[src[2]], float(src[3]) / 255.0f};
+		src += channels_v;
+	}
+}
+
+void encode_texel(SrgbTables const& tables, Texel const& texel,
+				  std::uint8_t* dst) {
+	auto const max_bucket = float(tables.search_start.size() - 1);
+	for (auto c = 0uz; c < 3; ++c) {
+		auto const linear = std::clamp(texel[c], 0.0f, 1.0f);
+		auto const bucket = static_cast<std::size_t>(linear * max_bucket);
+		auto code = std::size_t{tables.search_start[bucket]};
+		while (code < tables.thresholds.size() &&
+			   linear >= tables.thresholds[code]) {
+			++code;
+		}
+		dst[c] = static_cast<std::uint8_t>(code);
+	}
+	dst[3] = static_cast<std::uint8_t>(texel[3] * 255.0f + 0.5f);
+}
+
+// averages 4 linear texels: (a + b) + (c + d) on every path.
+[[nodiscard]] auto average(Texel const& a, Texel const& b, Texel const& c,
+						   Texel const& d) -> Texel {
+	auto ret = Texel{};
+#if defined(LVK_MIP_SSE2)
+	auto const sum = _mm_add_ps(_mm_add_ps(_mm_loadu_ps(a.data()),
+										   _mm_loadu_ps(b.data())),
+								_mm_add_ps(_mm_loadu_ps(c.data()),
+										   _mm_loadu_ps(d.data())));
+	_mm_storeu_ps(ret.data(), _mm_mul_ps(sum, _mm_set1_ps(0.25f)));
+#elif defined(LVK_MIP_NEON)
+	auto const sum = vaddq_f32(vaddq_f32(vld1q_f32(a.data()),
+										 vld1q_f32(b.data())),
+							   vaddq_f32(vld1q_f32(c.data()),
+										 vld1q_f32(d.data())));
+	vst1q_f32(ret.data(), vmulq_n_f32(sum, 0.25f));
+#else
+	for (auto i = 0uz; i < channels_v; ++i) {
+		ret[i] = ((a[i] + b[i]) + (c[i] + d[i])) * 0.25f;
+	}
+#endif
+	return ret;
+}
+
+// averages 2x2 texels of src (clamped to its edges) into each texel of dst.
+void downsample(std::uint8_t const* src, vk::Extent2D const src_extent,
+				std::uint8_t* dst, vk::Extent2D const dst_extent) {
+	auto const& tables = get_srgb_tables();
+	auto const src_pitch = src_extent.width * channels_v;
+	auto const dst_pitch = dst_extent.width * channels_v;
+	auto row0 = std::vector<Texel>(src_extent.width);
+	auto row1 = std::vector<Texel>(src_extent.width);
+	for (auto y = 0u; y < dst_extent.height; ++y) {
+		auto const y1 = std::min(2 * y + 1, src_extent.height - 1);
+		decode_row(tables, src + 2 * y * src_pitch, row0);
+		decode_row(tables, src + y1 * src_pitch, row1);
+		auto* out = dst + y * dst_pitch;
+		for (auto x = 0u; x < dst_extent.width; ++x) {
+			auto const x0 = 2 * x;
+			auto const x1 = std::min(2 * x + 1, src_extent.width - 1);
+			auto const texel =
+				average(row0[x0], row0[x1], row1[x0], row1[x1]);
+			encode_texel(tables, texel, out + x * channels_v);
+		}
+	}
+}
+
+[[nodiscard]] auto to_offset(vk::Extent2D const extent) -> vk::Offset3D {
+	return vk::Offset3D{static_cast<std::int32_t>(extent.width),
+						static_cast<std::int32_t>(extent.height), 1};
+}
+} // namespace
+
+auto get_mip_levels(vk::Extent2D const extent) -> std::uint32_t {
+	auto const size = std::max({extent.width, extent.height, 1u});
+	return static_cast<std::uint32_t>(std::bit_width(size));
+}
+
+auto get_mip_extent(vk::Extent2D const extent, std::uint32_t const level)
+	-> vk::Extent2D {
+	return vk::Extent2D{std::max(extent.width >> level, 1u),
+						std::max(extent.height >> level, 1u)};
+}
+
+auto can_blit_mips(vk::PhysicalDevice const physical_device,
+				   vk::Format const format) -> bool {
+	static constexpr auto required_v =
+		vk::FormatFeatureFlagBits::eBlitSrc |
+		vk::FormatFeatureFlagBits::eBlitDst |
+		vk::FormatFeatureFlagBits::eSampledImageFilterLinear;
+	auto const properties = physical_device.getFormatProperties(format);
+	return (properties.optimalTilingFeatures & required_v) == required_v;
+}
+
+void record_mip_blits(vk::CommandBuffer const command_buffer,
+					  vk::Image const image, vk::Extent2D const extent,
+					  std::uint32_t const first, std::uint32_t const levels) {
+	if (first == 0 || first > levels) {
+		throw std::invalid_argument{"Invalid first mip level to blit"};
+	}
+	// levels [0, first) are blit sources.
+	auto dependency_info = vk::DependencyInfo{};
+	auto subresource_range = vk::ImageSubresourceRange{};
+	subresource_range.setAspectMask(vk::ImageAspectFlagBits::eColor)
+		.setLayerCount(1)
+		.setLevelCount(first);
+	auto barrier = vk::ImageMemoryBarrier2{};
+	barrier.setImage(image)
+		.setSrcQueueFamilyIndex(vk::QueueFamilyIgnored)
+		.setDstQueueFamilyIndex(vk::QueueFamilyIgnored)
+		.setOldLayout(vk::ImageLayout::eTransferDstOptimal)
+		.setNewLayout(vk::ImageLayout::eTransferSrcOptimal)
+		.setSubresourceRange(subresource_range)
+		.setSrcStageMask(vk::PipelineStageFlagBits2::eTransfer)
+		.setSrcAccessMask(vk::AccessFlagBits2::eTransferWrite)
+		.setDstStageMask(vk::PipelineStageFlagBits2::eTransfer)
+		.setDstAccessMask(vk::AccessFlagBits2::eTransferRead);
+	dependency_info.setImageMemoryBarriers(barrier);
+	command_buffer.pipelineBarrier2(dependency_info);
+
+	for (auto level = first; level < levels; ++level) {
+		auto src_layers = vk::ImageSubresourceLayers{};
+		src_layers.setAspectMask(vk::ImageAspectFlagBits::eColor)
+			.setMipLevel(level - 1)
+			.setLayerCount(1);
+		auto dst_layers = src_layers;
+		dst_layers.setMipLevel(level);
+		auto blit = vk::ImageBlit2{};
+		blit.setSrcSubresource(src_layers)
+			.setSrcOffsets(
+				{vk::Offset3D{}, to_offset(get_mip_extent(extent, level - 1))})
+			.setDstSubresource(dst_layers)
+			.setDstOffsets(
+				{vk::Offset3D{}, to_offset(get_mip_extent(extent, level))});
+		auto blit_info = vk::BlitImageInfo2{};
+		blit_info.setSrcImage(image)
+			.setSrcImageLayout(vk::ImageLayout::eTransferSrcOptimal)
+			.setDstImage(image)
+			.setDstImageLayout(vk::ImageLayout::eTransferDstOptimal)
+			.setRegions(blit)
+			.setFilter(vk::Filter::eLinear);
+		command_buffer.blitImage2(blit_info);
+
+		// source of the next level.
+		subresource_range.setBaseMipLevel(level).setLevelCount(1);
+		barrier.setSubresourceRange(subresource_range);
+		dependency_info.setImageMemoryBarriers(barrier);
+		command_buffer.pipelineBarrier2(dependency_info);
+	}
+}
+
+auto build_mip_chain(Bitmap const& bitmap, std::uint32_t const levels)
+	-> MipChain {
+	auto const zone = trace::Zone{"build_mip_chain"};
+	if (bitmap.size.x <= 0 || bitmap.size.y <= 0 || levels == 0) { return {}; }
+	auto const extent = vk::Extent2D{static_cast<std::uint32_t>(bitmap.size.x),
+									 static_cast<std::uint32_t>(bitmap.size.y)};
+	auto const level_size = [extent](std::uint32_t const level) {
+		auto const e = get_mip_extent(extent, level);
+		return vk::DeviceSize{e.width} * e.height * channels_v;
+	};
+	if (bitmap.bytes.size() != level_size(0)) {
+		throw std::invalid_argument{"Bitmap size does not match its bytes"};
+	}
+
+	auto ret = MipChain{};
+	ret.offsets.reserve(levels);
+	auto total = vk::DeviceSize{};
+	for (auto level = 0u; level < levels; ++level) {
+		ret.offsets.push_back(total);
+		total += level_size(level);
+	}
+	ret.bytes.resize(total);
+	std::memcpy(ret.bytes.data(), bitmap.bytes.data(), bitmap.bytes.size());
+
+	auto* data = reinterpret_cast<std::uint8_t*>(ret.bytes.data());
+	for (auto level = 1u; level < levels; ++level) {
+		downsample(data + ret.offsets.at(level - 1),
+				   get_mip_extent(extent, level - 1),
+				   data + ret.offsets.at(level), get_mip_extent(extent, level));
+	}
+	return ret;
+}
+} // namespace lvk
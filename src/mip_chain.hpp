@@ -0,0 +1,38 @@
+#pragma once
+#include <bitmap.hpp>
+#include <vulkan/vulkan.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace lvk {
+// number of levels in a full mip chain (down to 1x1).
+[[nodiscard]] auto get_mip_levels(vk::Extent2D extent) -> std::uint32_t;
+[[nodiscard]] auto get_mip_extent(vk::Extent2D extent, std::uint32_t level)
+	-> vk::Extent2D;
+
+// whether mip levels of optimal tiling images of format can be generated with
+// linear blits.
+[[nodiscard]] auto can_blit_mips(vk::PhysicalDevice physical_device,
+								 vk::Format format) -> bool;
+
+// records blits generating levels [first, levels) of image, each from the
+// previous one. all levels must be in TransferDstOptimal with levels below
+// first written by transfer commands, all of them end up in
+// TransferSrcOptimal. needs a graphics queue.
+void record_mip_blits(vk::CommandBuffer command_buffer, vk::Image image,
+					  vk::Extent2D extent, std::uint32_t first,
+					  std::uint32_t levels);
+
+// CPU fallback for blits: levels [0, levels) of a 4-channel bitmap, tightly
+// packed back to back.
+struct MipChain {
+	std::vector<std::byte> bytes{};
+	std::vector<vk::DeviceSize> offsets{}; // of each level in bytes.
+};
+
+// each level is a 2x2 box filter of the previous one, averaged in linear
+// space: texels are R8G8B8A8Srgb, filtered like blits of that format.
+[[nodiscard]] auto build_mip_chain(Bitmap const& bitmap, std::uint32_t levels)
+	-> MipChain;
+} // namespace lvk
@@ -0,0 +1,69 @@
+#include <offscreen.hpp>
+#include <print>
+#include <stdexcept>
+
+namespace lvk {
+namespace {
+constexpr auto subresource_range_v = [] {
+	auto ret = vk::ImageSubresourceRange{};
+	ret.setAspectMask(vk::ImageAspectFlagBits::eColor)
+		.setLayerCount(1)
+		.setLevelCount(1);
+	return ret;
+}();
+} // namespace
+
+Offscreen::Offscreen(CreateInfo const& create_info)
+	: m_queue_family(create_info.queue_family), m_size(create_info.size),
+	  m_format(create_info.format) {
+	if (m_size.x <= 0 || m_size.y <= 0) {
+		throw std::runtime_error{"Invalid offscreen render target size"};
+	}
+
+	auto const image_ci = vma::ImageCreateInfo{
+		.allocator = create_info.allocator,
+		.queue_family = m_queue_family,
+	};
+	// TransferSrc allows copying rendered frames out for inspection.
+	static constexpr auto usage_v = vk::ImageUsageFlagBits::eColorAttachment |
+									vk::ImageUsageFlagBits::eTransferSrc;
+	auto const usize = glm::uvec2{m_size};
+	auto const extent = vk::Extent2D{usize.x, usize.y};
+
+	m_images.resize(create_info.buffering);
+	auto image_view_ci = vk::ImageViewCreateInfo{};
+	image_view_ci.setViewType(vk::ImageViewType::e2D)
+		.setFormat(m_format)
+		.setSubresourceRange(subresource_range_v);
+	for (auto& image : m_images) {
+		image.image = vma::create_image(image_ci, usage_v, 1, m_format, extent);
+		if (!image.image.get().image) {
+			throw std::runtime_error{"Failed to create offscreen Image"};
+		}
+		image_view_ci.setImage(image.image.get().image);
+		image.view = create_info.device.createImageViewUnique(image_view_ci);
+	}
+
+	std::println("[lvk] Offscreen [{}x{}]", m_size.x, m_size.y);
+}
+
+auto Offscreen::acquire_next_image() -> RenderTarget {
+	m_image_index = m_next_index;
+	m_next_index = (m_next_index + 1) % m_images.size();
+	auto const& image = m_images.at(m_image_index);
+	return RenderTarget{
+		.image = image.image.get().image,
+		.image_view = *image.view,
+		.extent = image.image.get().extent,
+	};
+}
+
+auto Offscreen::base_barrier() const -> vk::ImageMemoryBarrier2 {
+	auto ret = vk::ImageMemoryBarrier2{};
+	ret.setImage(m_images.at(m_image_index).image.get().image)
+		.setSubresourceRange(subresource_range_v)
+		.setSrcQueueFamilyIndex(m_queue_family)
+		.setDstQueueFamilyIndex(m_queue_family);
+	return ret;
+}
+} // namespace lvk
@@ -0,0 +1,49 @@
+#pragma once
+#include <glm/vec2.hpp>
+#include <render_target.hpp>
+#include <resource_buffering.hpp>
+#include <vma.hpp>
+
+namespace lvk {
+struct OffscreenCreateInfo {
+	vk::Device device;
+	VmaAllocator allocator;
+	std::uint32_t queue_family;
+	glm::ivec2 size;
+	// number of images (virtual frames).
+	std::size_t buffering{resource_buffering_v};
+	vk::Format format{vk::Format::eR8G8B8A8Srgb};
+};
+
+// Swapchain stand-in for headless rendering: owns one color image per virtual
+// frame and hands them out in round-robin order.
+class Offscreen {
+  public:
+	using CreateInfo = OffscreenCreateInfo;
+
+	explicit Offscreen(CreateInfo const& create_info);
+
+	[[nodiscard]] auto get_size() const -> glm::ivec2 { return m_size; }
+
+	[[nodiscard]] auto get_format() const -> vk::Format { return m_format; }
+
+	// never fails: there is no presentation engine to go out of date.
+	[[nodiscard]] auto acquire_next_image() -> RenderTarget;
+
+	[[nodiscard]] auto base_barrier() const -> vk::ImageMemoryBarrier2;
+
+  private:
+	struct Image {
+		vma::Image image{};
+		vk::UniqueImageView view{};
+	};
+
+	std::uint32_t m_queue_family{};
+	glm::ivec2 m_size{};
+	vk::Format m_format{};
+
+	Buffered<Image> m_images{};
+	std::size_t m_image_index{};
+	std::size_t m_next_index{};
+};
+} // namespace lvk
@@ -0,0 +1,106 @@
+#include <imgui.h>
+#include <perf_stats.hpp>
+#include <algorithm>
+#include <cassert>
+#include <format>
+#include <fstream>
+#include <numeric>
+#include <print>
+#include <ranges>
+#include <vector>
+
+namespace lvk {
+void SampleHistory::push(float const sample) {
+	m_samples.at(m_next) = sample;
+	m_next = (m_next + 1) % capacity_v;
+	m_size = std::min(m_size + 1, capacity_v);
+}
+
+auto SampleHistory::at(std::size_t const i) const -> float {
+	assert(i < m_size);
+	return m_samples.at((raw_offset() + i) % capacity_v);
+}
+
+auto SampleHistory::latest() const -> float {
+	if (is_empty()) { return 0.0f; }
+	return at(m_size - 1);
+}
+
+auto SampleHistory::summarize() const -> SampleSummary {
+	if (is_empty()) { return {}; }
+	auto const samples = raw();
+	auto sorted = std::vector<float>{samples.begin(), samples.end()};
+	auto const p99_index = (sorted.size() * 99) / 100;
+	auto const p99 = sorted.begin() + static_cast<std::ptrdiff_t>(p99_index);
+	std::ranges::nth_element(sorted, p99);
+	auto const sum = std::accumulate(samples.begin(), samples.end(), 0.0f);
+	return SampleSummary{
+		.min = std::ranges::min(samples),
+		.avg = sum / static_cast<float>(samples.size()),
+		.p99 = *p99,
+	};
+}
+
+void PassTimings::push(std::span<float const, pass_count_v> pass_ms) {
+	auto total = 0.0f;
+	for (auto [history, ms] : std::views::zip(m_passes, pass_ms)) {
+		history.push(ms);
+		total += ms;
+	}
+	m_total.push(total);
+	++m_frames;
+}
+
+void PassTimings::inspect() const {
+	static auto const inspect_history = [](char const* label,
+										   SampleHistory const& history) {
+		auto const summary = history.summarize();
+		ImGui::Text("%-6s  min %6.3f  avg %6.3f  p99 %6.3f ms", label,
+					double(summary.min), double(summary.avg),
+					double(summary.p99));
+		auto const samples = history.raw();
+		auto const id = std::format("##{}", label);
+		ImGui::PlotLines(id.c_str(), samples.data(),
+						 static_cast<int>(samples.size()),
+						 static_cast<int>(history.raw_offset()), nullptr, 0.0f,
+						 summary.p99 * 1.5f, ImVec2{0.0f, 40.0f});
+	};
+
+	ImGui::SetNextWindowSize({360.0f, 240.0f}, ImGuiCond_Once);
+	if (ImGui::Begin("Perf")) {
+		ImGui::Text("GPU time over the last %zu frames", m_total.size());
+		ImGui::Separator();
+		for (auto const [name, history] :
+			 std::views::zip(pass_names_v, m_passes)) {
+			inspect_history(name.data(), history);
+		}
+		inspect_history("total", m_total);
+	}
+	ImGui::End();
+}
+
+void PassTimings::write_csv(std::filesystem::path const& path) const {
+	auto file = std::ofstream{path};
+	if (!file.is_open()) {
+		std::println(stderr, "[lvk] Failed to open '{}' for writing",
+					 path.generic_string());
+		return;
+	}
+
+	file << "frame";
+	for (auto const name : pass_names_v) { file << ',' << name << "_ms"; }
+	file << ",total_ms\n";
+
+	auto const rows = m_total.size();
+	auto const first_frame = m_frames - rows;
+	for (std::size_t i = 0; i < rows; ++i) {
+		file << (first_frame + i);
+		for (auto const& history : m_passes) {
+			file << std::format(",{:.4f}", history.at(i));
+		}
+		file << std::format(",{:.4f}\n", m_total.at(i));
+	}
+	std::println("[lvk] GPU pass timings written to '{}'",
+				 path.generic_string());
+}
+} // namespace lvk
@@ -0,0 +1,71 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string_view>
+
+namespace lvk {
+struct SampleSummary {
+	float min{};
+	float avg{};
+	float p99{};
+};
+
+// fixed-capacity ring buffer of the most recent samples.
+class SampleHistory {
+  public:
+	static constexpr std::size_t capacity_v{512};
+
+	void push(float sample);
+
+	[[nodiscard]] auto size() const -> std::size_t { return m_size; }
+	[[nodiscard]] auto is_empty() const -> bool { return m_size == 0; }
+
+	// i = 0 is the oldest sample.
+	[[nodiscard]] auto at(std::size_t i) const -> float;
+	[[nodiscard]] auto latest() const -> float;
+
+	[[nodiscard]] auto summarize() const -> SampleSummary;
+
+	// raw storage and offset to the oldest sample, for ImGui::PlotLines().
+	[[nodiscard]] auto raw() const -> std::span<float const> {
+		return std::span{m_samples}.first(m_size);
+	}
+	[[nodiscard]] auto raw_offset() const -> std::size_t {
+		return m_size < capacity_v ? 0 : m_next;
+	}
+
+  private:
+	std::array<float, capacity_v> m_samples{};
+	std::size_t m_next{};
+	std::size_t m_size{};
+};
+
+// GPU time (in milliseconds) spent in each render pass, per frame.
+class PassTimings {
+  public:
+	enum class Pass : std::uint8_t { Scene, ImGui, COUNT_ };
+
+	static constexpr auto pass_count_v = std::size_t(Pass::COUNT_);
+	static constexpr auto pass_names_v =
+		std::array<std::string_view, pass_count_v>{"scene", "imgui"};
+
+	void push(std::span<float const, pass_count_v> pass_ms);
+
+	[[nodiscard]] auto history(Pass pass) const -> SampleHistory const& {
+		return m_passes.at(std::size_t(pass));
+	}
+
+	// draws a "Perf" window with per-pass stats and graphs.
+	void inspect() const;
+
+	// writes one row per recorded frame, oldest first.
+	void write_csv(std::filesystem::path const& path) const;
+
+  private:
+	std::array<SampleHistory, pass_count_v> m_passes{};
+	SampleHistory m_total{};
+	std::uint64_t m_frames{};
+};
+} // namespace lvk
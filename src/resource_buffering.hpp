@@ -1,11 +1,63 @@
 #pragma once
 #include <array>
+#include <cstddef>
+#include <stdexcept>
 
 namespace lvk {
-// Number of virtual frames.
+// Default number of virtual frames.
 inline constexpr std::size_t resource_buffering_v{2};
+// Maximum number of virtual frames that can be selected at startup.
+inline constexpr std::size_t max_resource_buffering_v{4};
 
-// Alias for N-buffered resources.
+// N-buffered resources, where N is chosen at runtime (up to
+// max_resource_buffering_v). Storage is inline, only the first N elements are
+// in use.
 template <typename Type>
-using Buffered = std::array<Type, resource_buffering_v>;
+class Buffered {
+  public:
+	using value_type = Type;
+	using iterator =
+		typename std::array<Type, max_resource_buffering_v>::iterator;
+	using const_iterator =
+		typename std::array<Type, max_resource_buffering_v>::const_iterator;
+
+	// throws if count is not in [1, max_resource_buffering_v].
+	void resize(std::size_t const count) {
+		if (count == 0 || count > max_resource_buffering_v) {
+			throw std::invalid_argument{"Invalid resource buffering count"};
+		}
+		// release resources held by elements no longer in use.
+		for (std::size_t i = count; i < m_size; ++i) { m_storage[i] = Type{}; }
+		m_size = count;
+	}
+
+	[[nodiscard]] auto size() const -> std::size_t { return m_size; }
+
+	[[nodiscard]] auto at(std::size_t const index) -> Type& {
+		if (index >= m_size) { throw std::out_of_range{"Buffered::at"}; }
+		return m_storage[index];
+	}
+
+	[[nodiscard]] auto at(std::size_t const index) const -> Type const& {
+		if (index >= m_size) { throw std::out_of_range{"Buffered::at"}; }
+		return m_storage[index];
+	}
+
+	[[nodiscard]] auto begin() -> iterator { return m_storage.begin(); }
+	[[nodiscard]] auto end() -> iterator { return begin() + diff(); }
+	[[nodiscard]] auto begin() const -> const_iterator {
+		return m_storage.begin();
+	}
+	[[nodiscard]] auto end() const -> const_iterator {
+		return begin() + diff();
+	}
+
+  private:
+	[[nodiscard]] auto diff() const -> std::ptrdiff_t {
+		return static_cast<std::ptrdiff_t>(m_size);
+	}
+
+	std::array<Type, max_resource_buffering_v> m_storage{};
+	std::size_t m_size{resource_buffering_v};
+};
 } // namespace lvk
@@ -0,0 +1,69 @@
+#include <sampler_cache.hpp>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+
+namespace lvk {
+namespace {
+template <typename Type>
+constexpr auto to_bits(Type const value) {
+	if constexpr (std::is_floating_point_v<Type>) {
+		return std::bit_cast<std::uint32_t>(value);
+	} else {
+		return static_cast<std::uint64_t>(value);
+	}
+}
+
+void hash_combine(std::size_t& out, std::uint64_t const value) {
+	out ^= std::hash<std::uint64_t>{}(value) + 0x9e3779b9 + (out << 6) +
+		   (out >> 2);
+}
+} // namespace
+
+auto SamplerCache::get(vk::SamplerCreateInfo const& create_info)
+	-> vk::Sampler {
+	if (create_info.pNext != nullptr) {
+		throw std::invalid_argument{"Cannot cache chained SamplerCreateInfo"};
+	}
+	auto lock = std::scoped_lock{m_mutex};
+	auto it = m_samplers.find(create_info);
+	if (it == m_samplers.end()) {
+		auto sampler = m_device.createSamplerUnique(create_info);
+		it = m_samplers.emplace(create_info, std::move(sampler)).first;
+	}
+	return *it->second;
+}
+
+auto SamplerCache::get_size() const -> std::size_t {
+	auto lock = std::scoped_lock{m_mutex};
+	return m_samplers.size();
+}
+
+auto SamplerCache::Hasher::operator()(vk::SamplerCreateInfo const& ci) const
+	-> std::size_t {
+	auto ret = std::size_t{};
+	for (auto const value : {
+			 to_bits(static_cast<VkSamplerCreateFlags>(ci.flags)),
+			 to_bits(ci.magFilter),
+			 to_bits(ci.minFilter),
+			 to_bits(ci.mipmapMode),
+			 to_bits(ci.addressModeU),
+			 to_bits(ci.addressModeV),
+			 to_bits(ci.addressModeW),
+			 to_bits(ci.anisotropyEnable),
+			 to_bits(ci.compareEnable),
+			 to_bits(ci.compareOp),
+			 to_bits(ci.borderColor),
+			 to_bits(ci.unnormalizedCoordinates),
+		 }) {
+		hash_combine(ret, value);
+	}
+	for (auto const value : {ci.mipLodBias, ci.maxAnisotropy, ci.minLod,
+							 ci.maxLod}) {
+		hash_combine(ret, to_bits(value));
+	}
+	return ret;
+}
+} // namespace lvk
@@ -0,0 +1,32 @@
+#pragma once
+#include <vulkan/vulkan.hpp>
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+
+namespace lvk {
+// Creates each distinct sampler once: textures with identical sampler state
+// share a vk::Sampler. Create infos must not have a pNext chain.
+// Thread safe.
+class SamplerCache {
+  public:
+	explicit SamplerCache(vk::Device device) : m_device(device) {}
+
+	// returns the cached sampler for create_info, creating it if needed.
+	[[nodiscard]] auto get(vk::SamplerCreateInfo const& create_info)
+		-> vk::Sampler;
+
+	[[nodiscard]] auto get_size() const -> std::size_t;
+
+  private:
+	struct Hasher {
+		[[nodiscard]] auto operator()(vk::SamplerCreateInfo const& ci) const
+			-> std::size_t;
+	};
+
+	vk::Device m_device{};
+	mutable std::mutex m_mutex{};
+	std::unordered_map<vk::SamplerCreateInfo, vk::UniqueSampler, Hasher>
+		m_samplers{};
+};
+} // namespace lvk
@@ -0,0 +1,88 @@
+#include <secondary_recorder.hpp>
+#include <ranges>
+#include <stdexcept>
+
+namespace lvk {
+SecondaryRecorder::SecondaryRecorder(CreateInfo const& create_info)
+	: m_device(create_info.device), m_job_system(create_info.job_system),
+	  m_color_format(create_info.color_format),
+	  m_samples(create_info.samples) {
+	if (create_info.thread_count == 0 || m_job_system == nullptr) {
+		throw std::invalid_argument{"Recorder needs a JobSystem and threads"};
+	}
+
+	// pools are reset as a whole every frame.
+	auto command_pool_ci = vk::CommandPoolCreateInfo{};
+	command_pool_ci.setFlags(vk::CommandPoolCreateFlagBits::eTransient)
+		.setQueueFamilyIndex(create_info.queue_family);
+	auto command_buffer_ai = vk::CommandBufferAllocateInfo{};
+	command_buffer_ai.setCommandBufferCount(1).setLevel(
+		vk::CommandBufferLevel::eSecondary);
+
+	m_slices.resize(create_info.thread_count);
+	m_recorded.resize(create_info.thread_count);
+	m_jobs.reserve(create_info.thread_count);
+	for (auto& slice : m_slices) {
+		slice.command_pools.resize(create_info.buffering);
+		slice.command_buffers.resize(create_info.buffering);
+		for (auto [pool, command_buffer] :
+			 std::views::zip(slice.command_pools, slice.command_buffers)) {
+			pool = m_device.createCommandPoolUnique(command_pool_ci);
+			command_buffer_ai.setCommandPool(*pool);
+			command_buffer =
+				m_device.allocateCommandBuffers(command_buffer_ai).front();
+		}
+	}
+}
+
+auto SecondaryRecorder::record(std::size_t const frame_index,
+							   Record const& record)
+	-> std::span<vk::CommandBuffer const> {
+	// slice 0 is recorded by the calling thread, the rest as jobs.
+	m_jobs.clear();
+	for (std::size_t i = 1; i < m_slices.size(); ++i) {
+		m_jobs.push_back(m_job_system->submit(
+			[this, frame_index, i, &record] {
+				record_slice(frame_index, i, record);
+			}));
+	}
+	auto const wait_jobs = [this] {
+		for (auto const& job : m_jobs) { m_job_system->wait(job); }
+	};
+	try {
+		record_slice(frame_index, 0, record);
+	} catch (...) {
+		// jobs reference record: let them finish before unwinding.
+		wait_jobs();
+		throw;
+	}
+	wait_jobs();
+	return m_recorded;
+}
+
+void SecondaryRecorder::record_slice(std::size_t const frame_index,
+									 std::size_t const slice_index,
+									 Record const& record) {
+	auto& slice = m_slices.at(slice_index);
+	// the pool is only used by one job at a time.
+	m_device.resetCommandPool(*slice.command_pools.at(frame_index));
+	auto const command_buffer = slice.command_buffers.at(frame_index);
+
+	auto rendering_inheritance = vk::CommandBufferInheritanceRenderingInfo{};
+	rendering_inheritance.setColorAttachmentFormats(m_color_format)
+		.setRasterizationSamples(m_samples);
+	auto inheritance_info = vk::CommandBufferInheritanceInfo{};
+	inheritance_info.setPNext(&rendering_inheritance);
+	auto begin_info = vk::CommandBufferBeginInfo{};
+	// RenderPassContinue: executed entirely within a rendering instance.
+	begin_info
+		.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit |
+				  vk::CommandBufferUsageFlagBits::eRenderPassContinue)
+		.setPInheritanceInfo(&inheritance_info);
+
+	command_buffer.begin(begin_info);
+	record(command_buffer, slice_index);
+	command_buffer.end();
+	m_recorded.at(slice_index) = command_buffer;
+}
+} // namespace lvk
@@ -0,0 +1,63 @@
+#pragma once
+#include <job_system.hpp>
+#include <resource_buffering.hpp>
+#include <vulkan/vulkan.hpp>
+#include <functional>
+#include <vector>
+
+namespace lvk {
+struct SecondaryRecorderCreateInfo {
+	vk::Device device;
+	std::uint32_t queue_family;
+	// runs recording jobs, the calling thread records one slice itself.
+	JobSystem* job_system;
+	// number of secondary command buffers recorded in parallel per frame.
+	std::size_t thread_count;
+	// number of virtual frames.
+	std::size_t buffering;
+	// single color attachment, inherited by secondary command buffers.
+	vk::Format color_format;
+	vk::SampleCountFlagBits samples{vk::SampleCountFlagBits::e1};
+};
+
+// Records secondary command buffers on multiple threads, for execution inside
+// a dynamic rendering instance begun with eContentsSecondaryCommandBuffers.
+// Each slice (parallel job) owns a command pool per virtual frame.
+class SecondaryRecorder {
+  public:
+	using CreateInfo = SecondaryRecorderCreateInfo;
+	// thread_index is in [0, thread_count), 0 is the calling thread.
+	using Record = std::function<void(vk::CommandBuffer command_buffer,
+									  std::size_t thread_index)>;
+
+	explicit SecondaryRecorder(CreateInfo const& create_info);
+
+	[[nodiscard]] auto thread_count() const -> std::size_t {
+		return m_slices.size();
+	}
+
+	// invokes record on every thread in parallel and blocks until all are
+	// done. Returns the recorded command buffers, in thread order.
+	[[nodiscard]] auto record(std::size_t frame_index, Record const& record)
+		-> std::span<vk::CommandBuffer const>;
+
+  private:
+	struct Slice {
+		Buffered<vk::UniqueCommandPool> command_pools{};
+		Buffered<vk::CommandBuffer> command_buffers{};
+	};
+
+	void record_slice(std::size_t frame_index, std::size_t slice_index,
+					  Record const& record);
+
+	vk::Device m_device{};
+	JobSystem* m_job_system{};
+	vk::Format m_color_format{};
+	vk::SampleCountFlagBits m_samples{};
+
+	// each slice is only ever recorded by one job at a time.
+	std::vector<Slice> m_slices{};
+	std::vector<vk::CommandBuffer> m_recorded{};
+	std::vector<JobHandle> m_jobs{};
+};
+} // namespace lvk
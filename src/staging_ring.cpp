@@ -0,0 +1,577 @@
+#include <staging_ring.hpp>
+#include <mip_chain.hpp>
+#include <trace.hpp>
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+
+namespace lvk {
+namespace {
+// satisfies buffer-image copy offsets for all formats, including compressed.
+constexpr vk::DeviceSize alignment_v{16};
+
+[[nodiscard]] constexpr auto align_up(vk::DeviceSize const offset)
+	-> vk::DeviceSize {
+	return (offset + alignment_v - 1) & ~(alignment_v - 1);
+}
+} // namespace
+
+auto UploadHandle::is_ready() const -> bool {
+	return m_ring == nullptr || m_ring->is_complete(m_batch);
+}
+
+void UploadHandle::wait() const {
+	if (m_ring == nullptr) { return; }
+	if (!m_ring->wait(m_batch)) {
+		throw std::runtime_error{"Failed to wait for upload"};
+	}
+}
+
+StagingRing::StagingRing(CreateInfo const& create_info)
+	: m_info(create_info) {
+	auto const buffer_ci = vma::BufferCreateInfo{
+		.allocator = m_info.allocator,
+		.usage = vk::BufferUsageFlagBits::eTransferSrc,
+		.queue_family = m_info.queue_family,
+	};
+	// host buffers are persistently mapped.
+	m_buffer = vma::create_buffer(buffer_ci, vma::BufferMemoryType::Host,
+								  std::max(m_info.capacity, alignment_v));
+	if (!m_buffer.get().buffer) {
+		throw std::runtime_error{"Failed to create StagingRing buffer"};
+	}
+	m_open.serial = 1;
+	if (m_info.transfer_queue) {
+		// batches are tracked with a timeline of their own: values signaled
+		// by two queues would not be increasing.
+		m_transfer_timeline.emplace(m_info.device);
+		auto command_pool_ci = vk::CommandPoolCreateInfo{};
+		command_pool_ci.setQueueFamilyIndex(m_info.queue_family)
+			.setFlags(vk::CommandPoolCreateFlagBits::eTransient);
+		m_acquire_pool = m_info.device.createCommandPoolUnique(command_pool_ci);
+	}
+	m_waiter = m_info.device;
+}
+
+auto StagingRing::upload_buffer(vk::Buffer const dst,
+								vk::DeviceSize const dst_offset,
+								std::span<std::byte const> bytes)
+	-> UploadHandle {
+	if (bytes.empty()) { return {}; }
+	auto const staging = stage(bytes);
+	{
+		auto& recorder = get_recorder();
+		auto lock = std::scoped_lock{recorder.mutex};
+		auto buffer_copy = vk::BufferCopy2{};
+		buffer_copy.setSrcOffset(staging.offset)
+			.setDstOffset(dst_offset)
+			.setSize(bytes.size());
+		auto copy_buffer_info = vk::CopyBufferInfo2{};
+		copy_buffer_info.setSrcBuffer(staging.buffer)
+			.setDstBuffer(dst)
+			.setRegions(buffer_copy);
+		auto const command_buffer = begin_recording(recorder);
+		command_buffer.copyBuffer2(copy_buffer_info);
+		if (uses_transfer_queue()) {
+			release_buffer(recorder, command_buffer, dst, dst_offset,
+						   bytes.size());
+		}
+	}
+	finish_write();
+	return UploadHandle{this, staging.batch};
+}
+
+auto StagingRing::upload_image(vk::Image const dst, vk::Extent2D const extent,
+							   std::uint32_t const levels,
+							   std::span<std::byte const> bytes,
+							   std::span<vk::DeviceSize const> level_offsets)
+	-> UploadHandle {
+	if (bytes.empty()) { return {}; }
+	// levels in bytes, the rest are blitted.
+	auto const staged = level_offsets.empty()
+							? 1u
+							: static_cast<std::uint32_t>(level_offsets.size());
+	if (staged > levels) {
+		throw std::invalid_argument{"More staged mip levels than levels"};
+	}
+	auto const blit = staged < levels;
+	if (blit && uses_transfer_queue()) {
+		throw std::invalid_argument{"Mip blits need a graphics queue"};
+	}
+	auto const staging = stage(bytes);
+	{
+		auto& recorder = get_recorder();
+		auto lock = std::scoped_lock{recorder.mutex};
+		auto const command_buffer = begin_recording(recorder);
+
+		// transition all levels for transfer.
+		auto dependency_info = vk::DependencyInfo{};
+		auto subresource_range = vk::ImageSubresourceRange{};
+		subresource_range.setAspectMask(vk::ImageAspectFlagBits::eColor)
+			.setLayerCount(1)
+			.setLevelCount(levels);
+		auto barrier = vk::ImageMemoryBarrier2{};
+		barrier.setImage(dst)
+			.setSrcQueueFamilyIndex(vk::QueueFamilyIgnored)
+			.setDstQueueFamilyIndex(vk::QueueFamilyIgnored)
+			.setOldLayout(vk::ImageLayout::eUndefined)
+			.setNewLayout(vk::ImageLayout::eTransferDstOptimal)
+			.setSubresourceRange(subresource_range)
+			.setSrcStageMask(vk::PipelineStageFlagBits2::eTopOfPipe)
+			.setSrcAccessMask(vk::AccessFlagBits2::eNone)
+			.setDstStageMask(vk::PipelineStageFlagBits2::eTransfer)
+			.setDstAccessMask(vk::AccessFlagBits2::eTransferWrite);
+		dependency_info.setImageMemoryBarriers(barrier);
+		command_buffer.pipelineBarrier2(dependency_info);
+
+		// copy staged levels.
+		auto buffer_image_copies = std::vector<vk::BufferImageCopy2>{};
+		buffer_image_copies.reserve(staged);
+		for (auto level = 0u; level < staged; ++level) {
+			auto const offset =
+				level_offsets.empty() ? 0 : level_offsets[level];
+			auto const level_extent = get_mip_extent(extent, level);
+			auto subresource_layers = vk::ImageSubresourceLayers{};
+			subresource_layers.setAspectMask(vk::ImageAspectFlagBits::eColor)
+				.setMipLevel(level)
+				.setLayerCount(1);
+			auto& buffer_image_copy = buffer_image_copies.emplace_back();
+			buffer_image_copy.setBufferOffset(staging.offset + offset)
+				.setImageSubresource(subresource_layers)
+				.setImageExtent(
+					vk::Extent3D{level_extent.width, level_extent.height, 1});
+		}
+		auto copy_info = vk::CopyBufferToImageInfo2{};
+		copy_info.setDstImage(dst)
+			.setDstImageLayout(vk::ImageLayout::eTransferDstOptimal)
+			.setSrcBuffer(staging.buffer)
+			.setRegions(buffer_image_copies);
+		command_buffer.copyBufferToImage2(copy_info);
+
+		auto layout = vk::ImageLayout::eTransferDstOptimal;
+		if (blit) {
+			record_mip_blits(command_buffer, dst, extent, staged, levels);
+			layout = vk::ImageLayout::eTransferSrcOptimal;
+		}
+
+		// transition all levels for sampling.
+		barrier.setOldLayout(layout)
+			.setNewLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
+			.setSrcStageMask(barrier.dstStageMask)
+			.setSrcAccessMask(barrier.dstAccessMask)
+			.setDstStageMask(vk::PipelineStageFlagBits2::eAllCommands)
+			.setDstAccessMask(vk::AccessFlagBits2::eMemoryRead);
+		if (uses_transfer_queue()) {
+			release_image(recorder, command_buffer, barrier);
+		} else {
+			dependency_info.setImageMemoryBarriers(barrier);
+			command_buffer.pipelineBarrier2(dependency_info);
+		}
+	}
+	finish_write();
+	return UploadHandle{this, staging.batch};
+}
+
+void StagingRing::flush() {
+	auto const zone = trace::Zone{"StagingRing::flush"};
+	auto* timeline =
+		m_transfer_timeline ? &*m_transfer_timeline : m_info.timeline;
+	auto batch = Batch{};
+	auto fence = vk::UniqueFence{};
+	{
+		auto lock = std::unique_lock{m_mutex};
+		// uploads that have reserved space must finish recording first.
+		m_writers_done.wait(lock, [this] { return m_writers == 0; });
+		auto const serial = m_open.serial;
+		batch = std::exchange(m_open, Batch{.serial = serial + 1});
+		batch.end = m_head;
+		if (timeline == nullptr && !m_free_fences.empty()) {
+			fence = std::move(m_free_fences.back());
+			m_free_fences.pop_back();
+		}
+	}
+
+	// uploads recorded after the batch was sealed are submitted with it too:
+	// their handles (and ring space) belong to the next batch, which is
+	// conservative.
+	{
+		auto lock = std::scoped_lock{m_recorders_mutex};
+		for (auto& [thread_id, recorder] : m_recorders) {
+			auto recorder_lock = std::scoped_lock{recorder->mutex};
+			if (!recorder->command_buffer) { continue; }
+			if (uses_transfer_queue()) {
+				auto& acquires = recorder->acquires;
+				std::ranges::move(acquires.buffers,
+								  std::back_inserter(batch.acquires.buffers));
+				std::ranges::move(acquires.images,
+								  std::back_inserter(batch.acquires.images));
+				acquires = {};
+			} else {
+				// make all transfer writes visible to later submissions.
+				auto barrier = vk::MemoryBarrier2{};
+				barrier.setSrcStageMask(vk::PipelineStageFlagBits2::eTransfer)
+					.setSrcAccessMask(vk::AccessFlagBits2::eTransferWrite)
+					.setDstStageMask(vk::PipelineStageFlagBits2::eAllCommands)
+					.setDstAccessMask(vk::AccessFlagBits2::eMemoryRead |
+									  vk::AccessFlagBits2::eMemoryWrite);
+				auto dependency_info = vk::DependencyInfo{};
+				dependency_info.setMemoryBarriers(barrier);
+				recorder->command_buffer.pipelineBarrier2(dependency_info);
+			}
+			recorder->command_buffer.end();
+			batch.commands.push_back(RecordedCommands{
+				.recorder = recorder.get(),
+				.command_buffer = std::exchange(recorder->command_buffer, {}),
+			});
+		}
+	}
+
+	// an empty batch is complete as soon as the ones before it are.
+	if (!batch.commands.empty()) {
+		auto command_buffer_infos = std::vector<vk::CommandBufferSubmitInfo>{};
+		command_buffer_infos.reserve(batch.commands.size());
+		for (auto const& commands : batch.commands) {
+			command_buffer_infos.emplace_back(commands.command_buffer);
+		}
+		auto submit_info = vk::SubmitInfo2{};
+		submit_info.setCommandBufferInfos(command_buffer_infos);
+		auto const queue =
+			uses_transfer_queue() ? m_info.transfer_queue : m_info.queue;
+		if (timeline != nullptr) {
+			batch.timeline_value = timeline->next_value();
+			auto const signal_info =
+				timeline->signal_info(batch.timeline_value);
+			submit_info.setSignalSemaphoreInfos(signal_info);
+			queue.submit2(submit_info);
+		} else {
+			if (!fence) { fence = m_info.device.createFenceUnique({}); }
+			batch.fence = std::move(fence);
+			queue.submit2(submit_info, *batch.fence);
+		}
+	}
+
+	auto lock = std::scoped_lock{m_mutex};
+	if (fence) { m_free_fences.push_back(std::move(fence)); }
+	m_submitted.push_back(std::move(batch));
+	retire_completed();
+}
+
+void StagingRing::poll() {
+	auto lock = std::scoped_lock{m_mutex};
+	retire_completed();
+}
+
+auto StagingRing::record_acquires(vk::CommandBuffer const command_buffer)
+	-> std::optional<vk::SemaphoreSubmitInfo> {
+	auto lock = std::scoped_lock{m_mutex};
+	if (m_pending_serial <= m_completed.load(std::memory_order_relaxed)) {
+		return {};
+	}
+	if (!m_pending_acquires.empty()) {
+		auto dependency_info = vk::DependencyInfo{};
+		dependency_info.setBufferMemoryBarriers(m_pending_acquires.buffers)
+			.setImageMemoryBarriers(m_pending_acquires.images);
+		command_buffer.pipelineBarrier2(dependency_info);
+		m_pending_acquires = {};
+	}
+	// resources are used after this point in command_buffer, or in later
+	// submissions.
+	m_completed.store(m_pending_serial, std::memory_order_release);
+	if (m_pending_value == 0) { return {}; }
+	// the batches have completed: this never blocks, but orders the acquires
+	// after the releases.
+	auto ret = vk::SemaphoreSubmitInfo{};
+	ret.setSemaphore(m_transfer_timeline->get_semaphore())
+		.setValue(m_pending_value)
+		.setStageMask(vk::PipelineStageFlagBits2::eAllCommands);
+	return ret;
+}
+
+auto StagingRing::wait(std::uint64_t const batch, Timeout const timeout)
+	-> bool {
+	if (is_complete(batch)) { return true; }
+	auto const zone = trace::Zone{"StagingRing::wait"};
+	auto const is_pending = [&] {
+		auto lock = std::scoped_lock{m_mutex};
+		return batch >= m_open.serial;
+	}();
+	if (is_pending) { flush(); }
+
+	// submitted batches are only retired on this thread: their fences stay
+	// valid while waiting outside the lock.
+	auto fences = std::vector<vk::Fence>{};
+	auto timeline_value = std::uint64_t{};
+	{
+		auto lock = std::scoped_lock{m_mutex};
+		for (auto const& submitted : m_submitted) {
+			if (submitted.serial > batch) { break; }
+			if (submitted.fence) { fences.push_back(*submitted.fence); }
+			timeline_value =
+				std::max(timeline_value, submitted.timeline_value);
+		}
+	}
+	auto ret = true;
+	if (auto const* timeline = get_batch_timeline()) {
+		ret = timeline->wait(timeline_value, timeout);
+	} else if (!fences.empty()) {
+		ret = m_info.device.waitForFences(
+				  fences, vk::True,
+				  static_cast<std::uint64_t>(timeout.count())) ==
+			  vk::Result::eSuccess;
+	}
+	poll();
+	if (uses_transfer_queue()) { acquire_now(); }
+	return ret && is_complete(batch);
+}
+
+void StagingRing::wait_idle() {
+	auto const batch = [this] {
+		auto lock = std::scoped_lock{m_mutex};
+		return m_open.serial;
+	}();
+	if (!wait(batch)) {
+		throw std::runtime_error{"Failed to wait for uploads"};
+	}
+}
+
+auto StagingRing::get_used() const -> vk::DeviceSize {
+	auto lock = std::scoped_lock{m_mutex};
+	return m_used;
+}
+
+auto StagingRing::stage(std::span<std::byte const> bytes) -> Staging {
+	auto const size = static_cast<vk::DeviceSize>(bytes.size());
+	auto ret = Staging{};
+	auto* dst = static_cast<std::byte*>(nullptr);
+	{
+		auto lock = std::scoped_lock{m_mutex};
+		if (auto const offset = allocate(size)) {
+			ret.buffer = m_buffer.get().buffer;
+			ret.offset = *offset;
+			dst = m_buffer.get().mapped_span().subspan(*offset).data();
+		} else {
+			// does not fit: use a dedicated buffer instead of blocking.
+			auto const buffer_ci = vma::BufferCreateInfo{
+				.allocator = m_info.allocator,
+				.usage = vk::BufferUsageFlagBits::eTransferSrc,
+				.queue_family = m_info.queue_family,
+			};
+			auto buffer = vma::create_buffer(
+				buffer_ci, vma::BufferMemoryType::Host, size);
+			if (!buffer.get().buffer) {
+				throw std::runtime_error{"Failed to create staging buffer"};
+			}
+			ret.buffer = buffer.get().buffer;
+			dst = static_cast<std::byte*>(buffer.get().mapped);
+			m_open.overflow.push_back(std::move(buffer));
+		}
+		ret.batch = m_open.serial;
+		++m_writers;
+	}
+	// copy outside the lock, other threads can stage concurrently.
+	std::memcpy(dst, bytes.data(), bytes.size());
+	return ret;
+}
+
+auto StagingRing::allocate(vk::DeviceSize const size)
+	-> std::optional<vk::DeviceSize> {
+	auto const capacity = m_buffer.get().size;
+	if (m_used == 0) {
+		// empty: restart from the front.
+		m_head = 0;
+		m_tail = 0;
+	}
+	auto const consume = [&](vk::DeviceSize const bytes,
+							 vk::DeviceSize const offset) {
+		m_used += bytes;
+		m_open.used += bytes;
+		m_head = offset + size;
+		return offset;
+	};
+	auto const offset = align_up(m_head);
+	if (m_used == 0 || m_head > m_tail) {
+		// free space is [head, capacity) and [0, tail).
+		if (offset + size <= capacity) {
+			return consume(offset + size - m_head, offset);
+		}
+		// wrap around, wasting the end of the ring.
+		if (size <= m_tail) { return consume(capacity - m_head + size, 0); }
+		return {};
+	}
+	// wrapped: free space is [head, tail).
+	if (offset + size <= m_tail) {
+		return consume(offset + size - m_head, offset);
+	}
+	return {};
+}
+
+void StagingRing::finish_write() {
+	{
+		auto lock = std::scoped_lock{m_mutex};
+		--m_writers;
+	}
+	m_writers_done.notify_all();
+}
+
+auto StagingRing::begin_recording(Recorder& recorder) const
+	-> vk::CommandBuffer {
+	if (recorder.command_buffer) { return recorder.command_buffer; }
+	auto allocate_info = vk::CommandBufferAllocateInfo{};
+	allocate_info.setCommandPool(*recorder.pool)
+		.setCommandBufferCount(1)
+		.setLevel(vk::CommandBufferLevel::ePrimary);
+	recorder.command_buffer =
+		m_info.device.allocateCommandBuffers(allocate_info).front();
+	auto begin_info = vk::CommandBufferBeginInfo{};
+	begin_info.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+	recorder.command_buffer.begin(begin_info);
+	return recorder.command_buffer;
+}
+
+auto StagingRing::get_recorder() -> Recorder& {
+	auto lock = std::scoped_lock{m_recorders_mutex};
+	auto& ret = m_recorders[std::this_thread::get_id()];
+	if (!ret) {
+		ret = std::make_unique<Recorder>();
+		auto command_pool_ci = vk::CommandPoolCreateInfo{};
+		command_pool_ci
+			.setQueueFamilyIndex(uses_transfer_queue()
+									 ? m_info.transfer_queue_family
+									 : m_info.queue_family)
+			.setFlags(vk::CommandPoolCreateFlagBits::eTransient);
+		ret->pool = m_info.device.createCommandPoolUnique(command_pool_ci);
+	}
+	return *ret;
+}
+
+void StagingRing::release_buffer(Recorder& recorder,
+								 vk::CommandBuffer const command_buffer,
+								 vk::Buffer const buffer,
+								 vk::DeviceSize const offset,
+								 vk::DeviceSize const size) const {
+	auto barrier = vk::BufferMemoryBarrier2{};
+	barrier.setBuffer(buffer)
+		.setOffset(offset)
+		.setSize(size)
+		.setSrcQueueFamilyIndex(m_info.transfer_queue_family)
+		.setDstQueueFamilyIndex(m_info.queue_family)
+		.setSrcStageMask(vk::PipelineStageFlagBits2::eTransfer)
+		.setSrcAccessMask(vk::AccessFlagBits2::eTransferWrite);
+	auto dependency_info = vk::DependencyInfo{};
+	dependency_info.setBufferMemoryBarriers(barrier);
+	command_buffer.pipelineBarrier2(dependency_info);
+
+	// the acquire only has a destination scope.
+	barrier.setSrcStageMask(vk::PipelineStageFlagBits2::eNone)
+		.setSrcAccessMask(vk::AccessFlagBits2::eNone)
+		.setDstStageMask(vk::PipelineStageFlagBits2::eAllCommands)
+		.setDstAccessMask(vk::AccessFlagBits2::eMemoryRead);
+	recorder.acquires.buffers.push_back(barrier);
+}
+
+void StagingRing::release_image(Recorder& recorder,
+								vk::CommandBuffer const command_buffer,
+								vk::ImageMemoryBarrier2 barrier) const {
+	// the release only has a source scope, the acquire a destination one.
+	auto const dst_stage = barrier.dstStageMask;
+	auto const dst_access = barrier.dstAccessMask;
+	barrier.setSrcQueueFamilyIndex(m_info.transfer_queue_family)
+		.setDstQueueFamilyIndex(m_info.queue_family)
+		.setDstStageMask(vk::PipelineStageFlagBits2::eNone)
+		.setDstAccessMask(vk::AccessFlagBits2::eNone);
+	auto dependency_info = vk::DependencyInfo{};
+	dependency_info.setImageMemoryBarriers(barrier);
+	command_buffer.pipelineBarrier2(dependency_info);
+
+	barrier.setSrcStageMask(vk::PipelineStageFlagBits2::eNone)
+		.setSrcAccessMask(vk::AccessFlagBits2::eNone)
+		.setDstStageMask(dst_stage)
+		.setDstAccessMask(dst_access);
+	recorder.acquires.images.push_back(barrier);
+}
+
+void StagingRing::acquire_now() {
+	{
+		auto lock = std::scoped_lock{m_mutex};
+		if (m_pending_serial <= m_completed.load(std::memory_order_relaxed)) {
+			return;
+		}
+	}
+	auto const zone = trace::Zone{"StagingRing::acquire_now"};
+	auto allocate_info = vk::CommandBufferAllocateInfo{};
+	allocate_info.setCommandPool(*m_acquire_pool)
+		.setCommandBufferCount(1)
+		.setLevel(vk::CommandBufferLevel::ePrimary);
+	auto command_buffers =
+		m_info.device.allocateCommandBuffersUnique(allocate_info);
+	auto const command_buffer = *command_buffers.front();
+	auto begin_info = vk::CommandBufferBeginInfo{};
+	begin_info.setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
+	command_buffer.begin(begin_info);
+	auto const wait_info = record_acquires(command_buffer);
+	command_buffer.end();
+
+	auto submit_info = vk::SubmitInfo2{};
+	auto const command_buffer_info =
+		vk::CommandBufferSubmitInfo{command_buffer};
+	submit_info.setCommandBufferInfos(command_buffer_info);
+	if (wait_info) { submit_info.setWaitSemaphoreInfos(*wait_info); }
+	auto fence = m_info.device.createFenceUnique({});
+	m_info.queue.submit2(submit_info, *fence);
+	auto const result = m_info.device.waitForFences(
+		*fence, vk::True, static_cast<std::uint64_t>(timeout_v.count()));
+	if (result != vk::Result::eSuccess) {
+		throw std::runtime_error{"Failed to acquire uploads"};
+	}
+}
+
+auto StagingRing::get_batch_timeline() const -> Timeline const* {
+	if (m_transfer_timeline) { return &*m_transfer_timeline; }
+	return m_info.timeline;
+}
+
+auto StagingRing::is_batch_complete(Batch const& batch) const -> bool {
+	if (batch.commands.empty()) { return true; }
+	if (auto const* timeline = get_batch_timeline()) {
+		return timeline->is_complete(batch.timeline_value);
+	}
+	return m_info.device.getFenceStatus(*batch.fence) == vk::Result::eSuccess;
+}
+
+void StagingRing::retire_completed() {
+	// batches complete in submission order.
+	while (!m_submitted.empty() && is_batch_complete(m_submitted.front())) {
+		auto& batch = m_submitted.front();
+		m_tail = batch.end;
+		m_used -= batch.used;
+		if (uses_transfer_queue()) {
+			// ready once acquired on the rendering queue.
+			auto& acquires = m_pending_acquires;
+			std::ranges::move(batch.acquires.buffers,
+							  std::back_inserter(acquires.buffers));
+			std::ranges::move(batch.acquires.images,
+							  std::back_inserter(acquires.images));
+			m_pending_serial = batch.serial;
+			m_pending_value = std::max(m_pending_value, batch.timeline_value);
+		} else {
+			m_completed.store(batch.serial, std::memory_order_release);
+		}
+		release(batch);
+		m_submitted.pop_front();
+	}
+}
+
+void StagingRing::release(Batch& batch) {
+	for (auto const& commands : batch.commands) {
+		auto lock = std::scoped_lock{commands.recorder->mutex};
+		m_info.device.freeCommandBuffers(*commands.recorder->pool,
+										 commands.command_buffer);
+	}
+	if (batch.fence) {
+		m_info.device.resetFences(*batch.fence);
+		m_free_fences.push_back(std::move(batch.fence));
+	}
+	// overflow buffers are destroyed with the batch.
+}
+} // namespace lvk
@@ -0,0 +1,223 @@
+#pragma once
+#include <scoped_waiter.hpp>
+#include <timeline.hpp>
+#include <vma.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace lvk {
+class StagingRing;
+
+// Future-like handle to an upload, ready once the batch it was recorded into
+// has completed on the GPU. A default constructed handle is always ready.
+class UploadHandle {
+  public:
+	UploadHandle() = default;
+
+	// non-blocking, thread safe.
+	[[nodiscard]] auto is_ready() const -> bool;
+	// submits pending uploads if needed and blocks until ready.
+	// throws on timeout. queue thread only.
+	void wait() const;
+
+  private:
+	explicit UploadHandle(StagingRing* ring, std::uint64_t batch)
+		: m_ring(ring), m_batch(batch) {}
+
+	StagingRing* m_ring{};
+	std::uint64_t m_batch{};
+
+	friend class StagingRing;
+};
+
+struct StagingRingCreateInfo {
+	vk::Device device;
+	VmaAllocator allocator;
+	// queue that uses the uploaded resources.
+	vk::Queue queue;
+	std::uint32_t queue_family;
+	// if not null, batches signal its next value instead of a fence.
+	Timeline* timeline{};
+	// if not null, uploads run on this queue instead, and ownership of the
+	// uploaded ranges is transferred to queue_family.
+	vk::Queue transfer_queue{};
+	std::uint32_t transfer_queue_family{};
+	// size of the persistently mapped ring in bytes.
+	vk::DeviceSize capacity{16 << 20};
+};
+
+// Persistently mapped host buffer that uploads are sub-allocated from in FIFO
+// order. Copies are recorded into per-thread command buffers (one command pool
+// per thread) and submitted together as a batch by flush(), space is reclaimed
+// once a batch completes. Uploads that do not fit in the free space get a
+// dedicated staging buffer owned by their batch, so they never block.
+// Completed batches are only reclaimed on the queue thread.
+// Single queue: each batch ends with a barrier that makes all its writes
+// visible to later submissions on the same queue, uploaded resources can be
+// used by any command buffer submitted after the flush.
+// Transfer queue: batches run concurrently with rendering, each upload
+// releases ownership of its range and the ring acquires it on the rendering
+// queue once the batch has completed (so acquires never stall it). Uploaded
+// resources must not be used before their handles are ready.
+// upload_*() and is_ready() are thread safe, all other functions must be
+// called on the thread that owns the queue(s).
+class StagingRing {
+  public:
+	using CreateInfo = StagingRingCreateInfo;
+	using Timeout = std::chrono::nanoseconds;
+
+	static constexpr auto timeout_v = Timeout{std::chrono::seconds{30}};
+
+	explicit StagingRing(CreateInfo const& create_info);
+
+	// copies bytes into dst at dst_offset.
+	// the returned handle may be discarded if completion is not needed.
+	auto upload_buffer(vk::Buffer dst, vk::DeviceSize dst_offset,
+					   std::span<std::byte const> bytes) -> UploadHandle;
+	// copies tightly packed bytes into a color image with levels mip levels,
+	// and transitions all of them from Undefined to ShaderReadOnlyOptimal.
+	// bytes holds level 0 only, or each level at its level_offsets entry.
+	// levels that are not staged are blitted from the last staged one, which
+	// needs a graphics queue: not supported with a transfer queue.
+	auto upload_image(vk::Image dst, vk::Extent2D extent, std::uint32_t levels,
+					  std::span<std::byte const> bytes,
+					  std::span<vk::DeviceSize const> level_offsets = {})
+		-> UploadHandle;
+
+	// submits all recorded uploads as one batch, then calls poll().
+	void flush();
+	// reclaims space and command buffers of completed batches.
+	void poll();
+	// transfer queue only: records acquires of completed batches into
+	// command_buffer (on the rendering queue). Its submission must wait on
+	// the returned semaphore, if any.
+	[[nodiscard]] auto record_acquires(vk::CommandBuffer command_buffer)
+		-> std::optional<vk::SemaphoreSubmitInfo>;
+	// flushes if batch has not been submitted yet, and waits for it (and all
+	// batches before it) to be ready. returns false on timeout.
+	[[nodiscard]] auto wait(std::uint64_t batch, Timeout timeout = timeout_v)
+		-> bool;
+	// waits for all uploads so far to be ready, throws on timeout.
+	void wait_idle();
+
+	[[nodiscard]] auto uses_transfer_queue() const -> bool {
+		return m_transfer_timeline.has_value();
+	}
+
+	[[nodiscard]] auto is_complete(std::uint64_t const batch) const -> bool {
+		return m_completed.load(std::memory_order_acquire) >= batch;
+	}
+
+	// bytes of the ring in use by pending batches.
+	[[nodiscard]] auto get_used() const -> vk::DeviceSize;
+	[[nodiscard]] auto get_capacity() const -> vk::DeviceSize {
+		return m_buffer.get().size;
+	}
+
+  private:
+	// ownership acquires matching the releases of a batch.
+	struct Acquires {
+		std::vector<vk::BufferMemoryBarrier2> buffers{};
+		std::vector<vk::ImageMemoryBarrier2> images{};
+
+		[[nodiscard]] auto empty() const -> bool {
+			return buffers.empty() && images.empty();
+		}
+	};
+
+	// command pool and open command buffer of one thread.
+	struct Recorder {
+		std::mutex mutex{};
+		vk::UniqueCommandPool pool{};
+		vk::CommandBuffer command_buffer{}; // null when not recording.
+		Acquires acquires{};
+	};
+
+	struct RecordedCommands {
+		Recorder* recorder{};
+		vk::CommandBuffer command_buffer{};
+	};
+
+	struct Batch {
+		std::uint64_t serial{};
+		vk::DeviceSize end{};  // ring head when submitted.
+		vk::DeviceSize used{}; // ring bytes, including padding.
+		std::vector<RecordedCommands> commands{};
+		std::vector<vma::Buffer> overflow{};
+		vk::UniqueFence fence{};
+		std::uint64_t timeline_value{};
+		Acquires acquires{};
+	};
+
+	// staging memory for one upload.
+	struct Staging {
+		vk::Buffer buffer{};
+		vk::DeviceSize offset{};
+		std::uint64_t batch{};
+	};
+
+	// reserves space (registering a writer) and copies bytes into it.
+	[[nodiscard]] auto stage(std::span<std::byte const> bytes) -> Staging;
+	// requires m_mutex to be locked, returns the offset if size fits.
+	[[nodiscard]] auto allocate(vk::DeviceSize size)
+		-> std::optional<vk::DeviceSize>;
+	// unregisters a writer, once its commands have been recorded.
+	void finish_write();
+	// returns the calling thread's open command buffer.
+	[[nodiscard]] auto begin_recording(Recorder& recorder) const
+		-> vk::CommandBuffer;
+	[[nodiscard]] auto get_recorder() -> Recorder&;
+	// transfer queue only: records the release half of an ownership
+	// transfer into command_buffer, and queues the acquire half.
+	void release_buffer(Recorder& recorder, vk::CommandBuffer command_buffer,
+						vk::Buffer buffer, vk::DeviceSize offset,
+						vk::DeviceSize size) const;
+	void release_image(Recorder& recorder, vk::CommandBuffer command_buffer,
+					   vk::ImageMemoryBarrier2 barrier) const;
+	// submits pending acquires on the rendering queue and waits for them.
+	void acquire_now();
+	[[nodiscard]] auto get_batch_timeline() const -> Timeline const*;
+	[[nodiscard]] auto is_batch_complete(Batch const& batch) const -> bool;
+	// requires m_mutex to be locked, queue thread only.
+	void retire_completed();
+	void release(Batch& batch);
+
+	CreateInfo m_info{};
+	vma::Buffer m_buffer{};
+
+	mutable std::mutex m_mutex{};
+	std::condition_variable m_writers_done{};
+	vk::DeviceSize m_head{};
+	vk::DeviceSize m_tail{};
+	vk::DeviceSize m_used{};
+	std::size_t m_writers{};
+	Batch m_open{};
+	std::deque<Batch> m_submitted{};
+	std::vector<vk::UniqueFence> m_free_fences{};
+	std::atomic<std::uint64_t> m_completed{};
+
+	// transfer queue only.
+	std::optional<Timeline> m_transfer_timeline{};
+	vk::UniqueCommandPool m_acquire_pool{};
+	Acquires m_pending_acquires{};
+	std::uint64_t m_pending_serial{}; // last retired batch.
+	std::uint64_t m_pending_value{};  // its transfer timeline value.
+
+	std::mutex m_recorders_mutex{};
+	std::unordered_map<std::thread::id, std::unique_ptr<Recorder>>
+		m_recorders{};
+
+	ScopedWaiter m_waiter{};
+};
+} // namespace lvk
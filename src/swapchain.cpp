@@ -1,4 +1,5 @@
 #include <swapchain.hpp>
+#include <trace.hpp>
 #include <algorithm>
 #include <array>
 #include <cassert>
@@ -101,6 +102,7 @@ Swapchain::Swapchain(vk::Device const device, Gpu const& gpu,
 }
 
 auto Swapchain::recreate(glm::ivec2 size) -> bool {
+	auto const zone = trace::Zone{"Swapchain::recreate"};
 	// Image sizes must be positive.
 	if (size.x <= 0 || size.y <= 0) { return false; }
 
@@ -1,5 +1,12 @@
 #include <texture.hpp>
+#include <mip_chain.hpp>
+#include <trace.hpp>
+#include <transcoder.hpp>
+#include <algorithm>
 #include <array>
+#include <exception>
+#include <print>
+#include <stdexcept>
 
 namespace lvk {
 namespace {
@@ -11,21 +18,25 @@ constexpr auto white_bitmap_v = Bitmap{
 	.bytes = white_pixel_v,
 	.size = {1, 1},
 };
+
+[[nodiscard]] auto can_sample(vk::PhysicalDevice const physical_device,
+							  vk::Format const format) -> bool {
+	static constexpr auto required_v =
+		vk::FormatFeatureFlagBits::eSampledImage |
+		vk::FormatFeatureFlagBits::eSampledImageFilterLinear;
+	auto const properties = physical_device.getFormatProperties(format);
+	return (properties.optimalTilingFeatures & required_v) == required_v;
+}
+
+// rows of 4x4 blocks per transcode job.
+constexpr auto transcode_grain_v = 16uz;
 } // namespace
 
 Texture::Texture(CreateInfo create_info) {
-	if (create_info.bitmap.bytes.empty() || create_info.bitmap.size.x <= 0 ||
-		create_info.bitmap.size.y <= 0) {
-		create_info.bitmap = white_bitmap_v;
+	if (create_info.ktx2 == nullptr || !upload_ktx2(create_info)) {
+		upload_bitmap(create_info);
 	}
 
-	auto const image_ci = vma::ImageCreateInfo{
-		.allocator = create_info.allocator,
-		.queue_family = create_info.queue_family,
-	};
-	m_image = vma::create_sampled_image(
-		image_ci, std::move(create_info.command_block), create_info.bitmap);
-
 	auto image_view_ci = vk::ImageViewCreateInfo{};
 	auto subresource_range = vk::ImageSubresourceRange{};
 	subresource_range.setAspectMask(vk::ImageAspectFlagBits::eColor)
@@ -38,14 +49,131 @@ Texture::Texture(CreateInfo create_info) {
 		.setSubresourceRange(subresource_range);
 	m_view = create_info.device.createImageViewUnique(image_view_ci);
 
-	m_sampler = create_info.device.createSamplerUnique(create_info.sampler);
+	m_sampler = create_info.samplers.get(create_info.sampler);
+}
+
+void Texture::upload_bitmap(CreateInfo const& create_info) {
+	auto bitmap = create_info.bitmap;
+	if (bitmap.bytes.empty() || bitmap.size.x <= 0 || bitmap.size.y <= 0) {
+		bitmap = white_bitmap_v;
+	}
+
+	auto const image_ci = vma::ImageCreateInfo{
+		.allocator = create_info.allocator,
+		.queue_family = create_info.queue_family,
+	};
+	auto const format = vk::Format::eR8G8B8A8Srgb;
+	auto const usize = glm::uvec2{bitmap.size};
+	auto const extent = vk::Extent2D{usize.x, usize.y};
+	auto const usage = vk::ImageUsageFlagBits::eTransferSrc |
+					   vk::ImageUsageFlagBits::eTransferDst |
+					   vk::ImageUsageFlagBits::eSampled;
+	m_image = vma::create_image(image_ci, usage, get_mip_levels(extent),
+								format, extent);
+	if (!m_image.get().image) {
+		throw std::runtime_error{"Failed to create Texture image"};
+	}
+	// usable by any submission after the ring's next flush.
+	auto& staging = create_info.staging;
+	auto const levels = m_image.get().levels;
+	auto const physical_device =
+		vma::get_physical_device(create_info.allocator);
+	if (!staging.uses_transfer_queue() &&
+		can_blit_mips(physical_device, format)) {
+		// the ring blits the other levels from level 0.
+		m_upload = staging.upload_image(m_image.get().image, extent, levels,
+										bitmap.bytes);
+	} else {
+		// transfer queues cannot blit: box filter on the CPU instead.
+		auto const chain = build_mip_chain(bitmap, levels);
+		m_upload = staging.upload_image(m_image.get().image, extent, levels,
+										chain.bytes, chain.offsets);
+	}
+}
+
+auto Texture::upload_ktx2(CreateInfo const& create_info) -> bool {
+	auto const& ktx2 = *create_info.ktx2;
+	auto const physical_device =
+		vma::get_physical_device(create_info.allocator);
+	auto const levels = static_cast<std::uint32_t>(ktx2.level_offsets.size());
+	auto const create_image = [&](vk::Format const format) {
+		auto const image_ci = vma::ImageCreateInfo{
+			.allocator = create_info.allocator,
+			.queue_family = create_info.queue_family,
+		};
+		auto const usage = vk::ImageUsageFlagBits::eTransferDst |
+						   vk::ImageUsageFlagBits::eSampled;
+		m_image =
+			vma::create_image(image_ci, usage, levels, format, ktx2.extent);
+		if (!m_image.get().image) {
+			throw std::runtime_error{"Failed to create Texture image"};
+		}
+	};
+
+	if (can_sample(physical_device, ktx2.format)) {
+		// upload the blocks as they are.
+		create_image(ktx2.format);
+		m_upload = create_info.staging.upload_image(
+			m_image.get().image, ktx2.extent, levels, ktx2.bytes,
+			ktx2.level_offsets);
+		return true;
+	}
+
+	auto const targets = get_transcode_formats(ktx2.format);
+	auto const it = std::ranges::find_if(targets, [&](vk::Format const f) {
+		return can_sample(physical_device, f);
+	});
+	if (it == targets.end()) {
+		std::println(stderr, "[lvk] KTX2 format {} cannot be sampled",
+					 vk::to_string(ktx2.format));
+		return false;
+	}
+
+	auto const zone = trace::Zone{"Texture::transcode"};
+	auto const target = *it;
+	auto offsets = std::vector<vk::DeviceSize>{};
+	offsets.reserve(levels);
+	auto size = vk::DeviceSize{};
+	for (auto level = 0u; level < levels; ++level) {
+		offsets.push_back(size);
+		size += get_level_size(target, get_mip_extent(ktx2.extent, level));
+	}
+	auto bytes = std::vector<std::byte>(size);
+	try {
+		for (auto level = 0u; level < levels; ++level) {
+			auto const extent = get_mip_extent(ktx2.extent, level);
+			auto const src = ktx2.get_level(level);
+			auto const dst = std::span{bytes}.subspan(
+				offsets.at(level), get_level_size(target, extent));
+			auto const transcode = [&](std::size_t const begin,
+									   std::size_t const end) {
+				transcode_rows(ktx2.format, target, src, extent, dst,
+							   static_cast<std::uint32_t>(begin),
+							   static_cast<std::uint32_t>(end));
+			};
+			auto const rows = (extent.height + 3) / 4;
+			if (create_info.jobs != nullptr) {
+				create_info.jobs->parallel_for(rows, transcode_grain_v,
+											   transcode);
+			} else {
+				transcode(0, rows);
+			}
+		}
+	} catch (std::exception const& e) {
+		std::println(stderr, "[lvk] Failed to transcode KTX2: {}", e.what());
+		return false;
+	}
+	create_image(target);
+	m_upload = create_info.staging.upload_image(
+		m_image.get().image, ktx2.extent, levels, bytes, offsets);
+	return true;
 }
 
 auto Texture::descriptor_info() const -> vk::DescriptorImageInfo {
 	auto ret = vk::DescriptorImageInfo{};
 	ret.setImageView(*m_view)
 		.setImageLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
-		.setSampler(*m_sampler);
+		.setSampler(m_sampler);
 	return ret;
 }
 } // namespace lvk
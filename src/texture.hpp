@@ -1,9 +1,18 @@
 #pragma once
+#include <job_system.hpp>
+#include <ktx2.hpp>
+#include <sampler_cache.hpp>
+#include <staging_ring.hpp>
 #include <vma.hpp>
 
 namespace lvk {
+// textures have full mip chains: filter is also used between levels
+// (trilinear for Linear), which minLod / maxLod can clamp.
 [[nodiscard]] constexpr auto
 create_sampler_ci(vk::SamplerAddressMode const wrap, vk::Filter const filter) {
+	auto const mipmap_mode = filter == vk::Filter::eLinear
+								 ? vk::SamplerMipmapMode::eLinear
+								 : vk::SamplerMipmapMode::eNearest;
 	auto ret = vk::SamplerCreateInfo{};
 	ret.setAddressModeU(wrap)
 		.setAddressModeV(wrap)
@@ -12,7 +21,7 @@ create_sampler_ci(vk::SamplerAddressMode const wrap, vk::Filter const filter) {
 		.setMagFilter(filter)
 		.setMaxLod(VK_LOD_CLAMP_NONE)
 		.setBorderColor(vk::BorderColor::eFloatTransparentBlack)
-		.setMipmapMode(vk::SamplerMipmapMode::eNearest);
+		.setMipmapMode(mipmap_mode);
 	return ret;
 }
 
@@ -23,8 +32,16 @@ struct TextureCreateInfo {
 	vk::Device device;
 	VmaAllocator allocator;
 	std::uint32_t queue_family;
-	CommandBlock command_block;
+	// bitmap is uploaded asynchronously through it.
+	StagingRing& staging;
+	// textures with the same sampler state share a sampler.
+	SamplerCache& samplers;
 	Bitmap bitmap;
+	// if not null, uploaded instead of bitmap. Formats the GPU cannot sample
+	// are transcoded, those that cannot be transcoded fall back to bitmap.
+	Ktx2Image const* ktx2{};
+	// if not null, transcodes are split across its workers.
+	JobSystem* jobs{};
 
 	vk::SamplerCreateInfo sampler{sampler_ci_v};
 };
@@ -37,9 +54,22 @@ class Texture {
 
 	[[nodiscard]] auto descriptor_info() const -> vk::DescriptorImageInfo;
 
+	// whether the upload has completed.
+	[[nodiscard]] auto is_ready() const -> bool { return m_upload.is_ready(); }
+
+	[[nodiscard]] auto get_format() const -> vk::Format {
+		return m_image.get().format;
+	}
+
   private:
+	// uses a white pixel if bitmap is empty.
+	void upload_bitmap(CreateInfo const& create_info);
+	// returns false if the image can neither be sampled nor transcoded.
+	[[nodiscard]] auto upload_ktx2(CreateInfo const& create_info) -> bool;
+
 	vma::Image m_image{};
 	vk::UniqueImageView m_view{};
-	vk::UniqueSampler m_sampler{};
+	vk::Sampler m_sampler{}; // owned by the SamplerCache.
+	UploadHandle m_upload{};
 };
 } // namespace lvk
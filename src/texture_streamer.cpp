@@ -0,0 +1,157 @@
+#include <texture_streamer.hpp>
+#include <ktx2.hpp>
+#include <trace.hpp>
+#include <algorithm>
+#include <exception>
+#include <format>
+#include <fstream>
+#include <print>
+#include <stdexcept>
+
+namespace lvk {
+namespace fs = std::filesystem;
+
+namespace {
+[[nodiscard]] auto to_bytes(fs::path const& path) -> std::vector<std::byte> {
+	auto file = std::ifstream{path, std::ios::binary | std::ios::ate};
+	if (!file.is_open()) {
+		throw std::runtime_error{
+			std::format("Failed to open file: '{}'", path.generic_string())};
+	}
+	auto const size = file.tellg();
+	file.seekg({}, std::ios::beg);
+	auto ret = std::vector<std::byte>(static_cast<std::size_t>(size));
+	void* data = ret.data();
+	file.read(static_cast<char*>(data), size);
+	return ret;
+}
+
+// an empty bitmap is uploaded as a white pixel.
+[[nodiscard]] auto
+create_placeholder_ci(TextureStreamerCreateInfo const& create_info)
+	-> TextureCreateInfo {
+	return TextureCreateInfo{
+		.device = create_info.device,
+		.allocator = create_info.allocator,
+		.queue_family = create_info.queue_family,
+		.staging = create_info.staging,
+		.samplers = create_info.samplers,
+		.bitmap = {},
+		.jobs = &create_info.jobs,
+	};
+}
+} // namespace
+
+TextureStreamer::TextureStreamer(CreateInfo const& create_info)
+	: m_texture_ci(create_placeholder_ci(create_info)),
+	  m_jobs(&create_info.jobs), m_placeholder(m_texture_ci) {}
+
+TextureStreamer::~TextureStreamer() {
+	// jobs reference this and the staging ring.
+	for (auto const& entry : m_entries) {
+		if (entry.job) { m_jobs->wait(entry.job); }
+	}
+}
+
+auto TextureStreamer::request(fs::path path,
+							  vk::SamplerCreateInfo const& sampler) -> Id {
+	auto const id = static_cast<Id>(m_entries.size());
+	auto& entry = m_entries.emplace_back();
+	entry.path = path;
+	// background: waits of the frame thread (eg on recording jobs) must not
+	// pick up loads or their transcodes.
+	entry.job = m_jobs->submit_background(
+		[this, id, path = std::move(path), sampler] {
+			load(id, path, sampler);
+		});
+	return id;
+}
+
+auto TextureStreamer::update() -> std::vector<Id> {
+	if (m_jobs->worker_count() == 0) {
+		// jobs only run on waiting threads: load one request per update.
+		auto const it = std::ranges::find_if(m_entries, [](Entry const& e) {
+			return e.job && !e.job.is_done();
+		});
+		if (it != m_entries.end()) { m_jobs->wait(it->job); }
+	}
+
+	auto loaded = std::vector<Loaded>{};
+	{
+		auto lock = std::scoped_lock{m_mutex};
+		std::swap(loaded, m_loaded);
+	}
+	for (auto& [id, texture] : loaded) {
+		auto& entry = m_entries.at(id);
+		entry.job = {};
+		if (!texture) {
+			entry.state = State::Failed;
+			continue;
+		}
+		entry.texture = std::move(texture);
+		entry.state = State::Uploading;
+	}
+
+	// transfer queue: uploads are ready once the ring has recorded their
+	// acquires, so resident textures can be sampled from this frame on.
+	auto ret = std::vector<Id>{};
+	for (auto id = Id{}; id < m_entries.size(); ++id) {
+		auto& entry = m_entries.at(id);
+		if (entry.state != State::Uploading || !entry.texture->is_ready()) {
+			continue;
+		}
+		entry.state = State::Resident;
+		ret.push_back(id);
+		std::println("[lvk] Texture streamed: '{}' ({})",
+					 entry.path.generic_string(),
+					 vk::to_string(entry.texture->get_format()));
+	}
+	return ret;
+}
+
+auto TextureStreamer::descriptor_info(Id const id) const
+	-> vk::DescriptorImageInfo {
+	if (!is_resident(id)) { return m_placeholder.descriptor_info(); }
+	return m_entries.at(id).texture->descriptor_info();
+}
+
+auto TextureStreamer::is_resident(Id const id) const -> bool {
+	return m_entries.at(id).state == State::Resident;
+}
+
+auto TextureStreamer::get_pending_count() const -> std::size_t {
+	return static_cast<std::size_t>(
+		std::ranges::count_if(m_entries, [](Entry const& e) {
+			return e.state == State::Loading || e.state == State::Uploading;
+		}));
+}
+
+auto TextureStreamer::get_resident_count() const -> std::size_t {
+	return static_cast<std::size_t>(
+		std::ranges::count_if(m_entries, [](Entry const& e) {
+			return e.state == State::Resident;
+		}));
+}
+
+void TextureStreamer::load(Id const id, fs::path const& path,
+						   vk::SamplerCreateInfo const& sampler) {
+	auto const zone = trace::Zone{"TextureStreamer::load"};
+	auto loaded = Loaded{.id = id};
+	try {
+		// the file only needs to outlive the Texture constructor, which
+		// transcodes and copies it into the ring.
+		auto const bytes = to_bytes(path);
+		if (auto const ktx2 = parse_ktx2(bytes)) {
+			auto texture_ci = m_texture_ci;
+			texture_ci.ktx2 = &*ktx2;
+			texture_ci.sampler = sampler;
+			loaded.texture.emplace(std::move(texture_ci));
+		}
+	} catch (std::exception const& e) {
+		std::println(stderr, "[lvk] Failed to stream texture '{}': {}",
+					 path.generic_string(), e.what());
+	}
+	auto lock = std::scoped_lock{m_mutex};
+	m_loaded.push_back(std::move(loaded));
+}
+} // namespace lvk
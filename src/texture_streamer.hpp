@@ -0,0 +1,91 @@
+#pragma once
+#include <job_system.hpp>
+#include <texture.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace lvk {
+struct TextureStreamerCreateInfo {
+	vk::Device device;
+	VmaAllocator allocator;
+	std::uint32_t queue_family;
+	// streamed textures are uploaded asynchronously through it.
+	StagingRing& staging;
+	SamplerCache& samplers;
+	// files are read, parsed and transcoded by background jobs on its
+	// workers.
+	JobSystem& jobs;
+};
+
+// Loads KTX2 textures in the background: each request is read, decoded and
+// uploaded by a job, and its id resolves to a 1x1 white placeholder until
+// the upload has completed. Frames never wait on streamed textures.
+// Not thread safe: all functions must be called on the queue thread.
+class TextureStreamer {
+  public:
+	using CreateInfo = TextureStreamerCreateInfo;
+	using Id = std::uint32_t;
+
+	explicit TextureStreamer(CreateInfo const& create_info);
+
+	TextureStreamer(TextureStreamer const&) = delete;
+	TextureStreamer(TextureStreamer&&) = delete;
+	auto operator=(TextureStreamer const&) = delete;
+	auto operator=(TextureStreamer&&) = delete;
+
+	// waits for outstanding jobs.
+	~TextureStreamer();
+
+	// submits a job to stream path, returns immediately.
+	[[nodiscard]] auto request(std::filesystem::path path,
+							   vk::SamplerCreateInfo const& sampler =
+								   sampler_ci_v) -> Id;
+
+	// takes finished jobs, returns the ids that became resident since the
+	// last call. Call once per frame, after the ring's acquires have been
+	// recorded.
+	[[nodiscard]] auto update() -> std::vector<Id>;
+
+	// the streamed texture if resident, else the placeholder.
+	[[nodiscard]] auto descriptor_info(Id id) const
+		-> vk::DescriptorImageInfo;
+	[[nodiscard]] auto is_resident(Id id) const -> bool;
+
+	// requests that are still loading or uploading.
+	[[nodiscard]] auto get_pending_count() const -> std::size_t;
+	[[nodiscard]] auto get_resident_count() const -> std::size_t;
+
+  private:
+	enum class State : std::uint8_t { Loading, Uploading, Resident, Failed };
+
+	struct Entry {
+		std::filesystem::path path{};
+		JobHandle job{};
+		std::optional<Texture> texture{};
+		State state{State::Loading};
+	};
+
+	// written by jobs: texture is empty if loading failed.
+	struct Loaded {
+		Id id{};
+		std::optional<Texture> texture{};
+	};
+
+	// runs on a worker.
+	void load(Id id, std::filesystem::path const& path,
+			  vk::SamplerCreateInfo const& sampler);
+
+	TextureCreateInfo m_texture_ci;
+	JobSystem* m_jobs{};
+	Texture m_placeholder;
+
+	std::vector<Entry> m_entries{};
+
+	std::mutex m_mutex{};
+	std::vector<Loaded> m_loaded{}; // guarded by m_mutex.
+};
+} // namespace lvk
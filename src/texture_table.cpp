@@ -0,0 +1,74 @@
+#include <texture_table.hpp>
+#include <stdexcept>
+
+namespace lvk {
+TextureTable::TextureTable(CreateInfo const& create_info)
+	: m_device(create_info.device), m_capacity(create_info.capacity) {
+	if (m_capacity == 0) {
+		throw std::invalid_argument{"Invalid TextureTable CreateInfo"};
+	}
+	static constexpr auto type_v = vk::DescriptorType::eCombinedImageSampler;
+
+	auto const binding = vk::DescriptorSetLayoutBinding{
+		0, type_v, m_capacity, create_info.stages};
+	static constexpr auto binding_flags_v =
+		vk::DescriptorBindingFlagBits::ePartiallyBound |
+		vk::DescriptorBindingFlagBits::eUpdateAfterBind;
+	auto binding_flags_ci = vk::DescriptorSetLayoutBindingFlagsCreateInfo{};
+	binding_flags_ci.setBindingFlags(binding_flags_v);
+	auto set_layout_ci = vk::DescriptorSetLayoutCreateInfo{};
+	set_layout_ci.setBindings(binding)
+		.setFlags(vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool)
+		.setPNext(&binding_flags_ci);
+	m_set_layout = m_device.createDescriptorSetLayoutUnique(set_layout_ci);
+
+	auto const pool_size = vk::DescriptorPoolSize{type_v, m_capacity};
+	auto pool_ci = vk::DescriptorPoolCreateInfo{};
+	pool_ci.setPoolSizes(pool_size)
+		.setMaxSets(1)
+		.setFlags(vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind);
+	m_pool = m_device.createDescriptorPoolUnique(pool_ci);
+
+	auto allocate_info = vk::DescriptorSetAllocateInfo{};
+	allocate_info.setDescriptorPool(*m_pool).setSetLayouts(*m_set_layout);
+	m_set = m_device.allocateDescriptorSets(allocate_info).front();
+}
+
+auto TextureTable::add(vk::DescriptorImageInfo const& texture) -> Slot {
+	auto slot = Slot{};
+	if (!m_free_slots.empty()) {
+		slot = m_free_slots.back();
+		m_free_slots.pop_back();
+	} else {
+		if (m_next == m_capacity) {
+			throw std::runtime_error{"TextureTable is full"};
+		}
+		slot = m_next++;
+	}
+	replace(slot, texture);
+	return slot;
+}
+
+void TextureTable::replace(Slot const slot,
+						   vk::DescriptorImageInfo const& texture) {
+	if (slot >= m_next) {
+		throw std::out_of_range{"Invalid TextureTable slot"};
+	}
+	auto write = vk::WriteDescriptorSet{};
+	write.setImageInfo(texture)
+		.setDescriptorType(vk::DescriptorType::eCombinedImageSampler)
+		.setDescriptorCount(1)
+		.setDstSet(m_set)
+		.setDstBinding(0)
+		.setDstArrayElement(slot);
+	m_device.updateDescriptorSets(write, {});
+}
+
+void TextureTable::remove(Slot const slot) {
+	if (slot >= m_next) {
+		throw std::out_of_range{"Invalid TextureTable slot"};
+	}
+	// partially bound: the stale descriptor is fine as long as it is unused.
+	m_free_slots.push_back(slot);
+}
+} // namespace lvk
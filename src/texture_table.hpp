@@ -0,0 +1,57 @@
+#pragma once
+#include <vulkan/vulkan.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace lvk {
+struct TextureTableCreateInfo {
+	vk::Device device;
+	// number of slots, at most Gpu::max_bindless_textures.
+	std::uint32_t capacity{4096};
+	vk::ShaderStageFlags stages{vk::ShaderStageFlagBits::eFragment};
+};
+
+// Bindless texture table: a single descriptor set with one large array of
+// combined image samplers (binding 0), which shaders index with a texture's
+// slot (non-uniformly). The binding is partially bound (only slots in use
+// must be valid) and update after bind, so textures can be added while the
+// set is bound by frames in flight, and any number of textures can be drawn
+// without rebinding.
+// Not thread safe.
+class TextureTable {
+  public:
+	using CreateInfo = TextureTableCreateInfo;
+	using Slot = std::uint32_t;
+
+	explicit TextureTable(CreateInfo const& create_info);
+
+	// writes texture into a free slot and returns it, throws if full.
+	[[nodiscard]] auto add(vk::DescriptorImageInfo const& texture) -> Slot;
+	// overwrites the texture in slot.
+	void replace(Slot slot, vk::DescriptorImageInfo const& texture);
+	// slot must no longer be used by pending command buffers.
+	void remove(Slot slot);
+
+	[[nodiscard]] auto get_set_layout() const -> vk::DescriptorSetLayout {
+		return *m_set_layout;
+	}
+	[[nodiscard]] auto get_set() const -> vk::DescriptorSet { return m_set; }
+
+	[[nodiscard]] auto get_size() const -> std::uint32_t {
+		return m_next - static_cast<std::uint32_t>(m_free_slots.size());
+	}
+	[[nodiscard]] auto get_capacity() const -> std::uint32_t {
+		return m_capacity;
+	}
+
+  private:
+	vk::Device m_device{};
+	std::uint32_t m_capacity{};
+	vk::UniqueDescriptorSetLayout m_set_layout{};
+	vk::UniqueDescriptorPool m_pool{};
+	vk::DescriptorSet m_set{};
+
+	Slot m_next{};
+	std::vector<Slot> m_free_slots{};
+};
+} // namespace lvk
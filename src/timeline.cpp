@@ -0,0 +1,37 @@
+#include <timeline.hpp>
+
+namespace lvk {
+Timeline::Timeline(vk::Device const device) : m_device(device) {
+	auto type_ci = vk::SemaphoreTypeCreateInfo{};
+	type_ci.setSemaphoreType(vk::SemaphoreType::eTimeline)
+		.setInitialValue(m_value);
+	auto semaphore_ci = vk::SemaphoreCreateInfo{};
+	semaphore_ci.setPNext(&type_ci);
+	m_semaphore = m_device.createSemaphoreUnique(semaphore_ci);
+}
+
+auto Timeline::completed_value() const -> std::uint64_t {
+	return m_device.getSemaphoreCounterValue(*m_semaphore);
+}
+
+auto Timeline::is_complete(std::uint64_t const value) const -> bool {
+	return completed_value() >= value;
+}
+
+auto Timeline::wait(std::uint64_t const value, Timeout const timeout) const
+	-> bool {
+	auto wait_info = vk::SemaphoreWaitInfo{};
+	wait_info.setSemaphores(*m_semaphore).setValues(value);
+	auto const result = m_device.waitSemaphores(
+		wait_info, static_cast<std::uint64_t>(timeout.count()));
+	return result == vk::Result::eSuccess;
+}
+
+auto Timeline::signal_info(std::uint64_t const value,
+						   vk::PipelineStageFlags2 const stage) const
+	-> vk::SemaphoreSubmitInfo {
+	auto ret = vk::SemaphoreSubmitInfo{};
+	ret.setSemaphore(*m_semaphore).setValue(value).setStageMask(stage);
+	return ret;
+}
+} // namespace lvk
@@ -0,0 +1,48 @@
+#pragma once
+#include <vulkan/vulkan.hpp>
+#include <chrono>
+#include <cstdint>
+
+namespace lvk {
+// Wrapper over a timeline semaphore with a monotonically increasing counter.
+// Each GPU submission signals a new value, CPU waits are value based.
+// Values must be signaled in the order they were obtained from next_value().
+class Timeline {
+  public:
+	using Timeout = std::chrono::nanoseconds;
+
+	explicit Timeline(vk::Device device);
+
+	[[nodiscard]] auto get_semaphore() const -> vk::Semaphore {
+		return *m_semaphore;
+	}
+
+	// increments and returns the value for the next submission to signal.
+	[[nodiscard]] auto next_value() -> std::uint64_t { return ++m_value; }
+
+	// last value obtained from next_value().
+	[[nodiscard]] auto last_value() const -> std::uint64_t { return m_value; }
+
+	// value most recently signaled by the GPU.
+	[[nodiscard]] auto completed_value() const -> std::uint64_t;
+
+	// non-blocking: whether the submission that signals value has completed.
+	[[nodiscard]] auto is_complete(std::uint64_t value) const -> bool;
+
+	// blocks until value is signaled, returns false on timeout.
+	[[nodiscard]] auto wait(std::uint64_t value, Timeout timeout) const
+		-> bool;
+
+	// SemaphoreSubmitInfo that signals value at stage.
+	[[nodiscard]] auto
+	signal_info(std::uint64_t value,
+				vk::PipelineStageFlags2 stage =
+					vk::PipelineStageFlagBits2::eAllCommands) const
+		-> vk::SemaphoreSubmitInfo;
+
+  private:
+	vk::Device m_device{};
+	vk::UniqueSemaphore m_semaphore{};
+	std::uint64_t m_value{};
+};
+} // namespace lvk
@@ -0,0 +1,143 @@
+#include <trace.hpp>
+#include <atomic>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <print>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace lvk {
+namespace {
+struct Event {
+	char const* name{};
+	trace::Clock::time_point start{};
+	trace::Clock::time_point end{};
+};
+
+struct ThreadBuffer {
+	std::uint32_t id{};
+	std::string name{};
+	std::vector<Event> events{};
+};
+
+// owns all thread buffers, so that recorded events outlive their threads.
+struct Registry {
+	std::mutex mutex{};
+	std::vector<std::unique_ptr<ThreadBuffer>> buffers{};
+	trace::Clock::time_point epoch{trace::Clock::now()};
+
+	static auto self() -> Registry& {
+		static auto ret = Registry{};
+		return ret;
+	}
+
+	auto register_thread() -> ThreadBuffer* {
+		// reserve up front to keep reallocation out of typical frames.
+		static constexpr std::size_t reserve_v{64 * 1024};
+		auto lock = std::scoped_lock{mutex};
+		auto const id = static_cast<std::uint32_t>(buffers.size());
+		auto buffer = std::make_unique<ThreadBuffer>();
+		buffer->id = id;
+		buffer->name = std::format("thread {}", id);
+		buffer->events.reserve(reserve_v);
+		return buffers.emplace_back(std::move(buffer)).get();
+	}
+};
+
+std::atomic<bool> g_enabled{}; // NOLINT
+
+auto this_thread_buffer() -> ThreadBuffer& {
+	// only the first access on each thread takes the registry lock.
+	thread_local auto* ret = Registry::self().register_thread();
+	return *ret;
+}
+
+[[nodiscard]] auto to_us(trace::Clock::duration const duration) -> double {
+	return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+// escapes text for use in a JSON string.
+[[nodiscard]] auto escape_json(std::string_view const text) -> std::string {
+	auto ret = std::string{};
+	ret.reserve(text.size());
+	for (char const c : text) {
+		switch (c) {
+		case '"': ret += "\\\""; break;
+		case '\\': ret += "\\\\"; break;
+		case '\n': ret += "\\n"; break;
+		case '\r': ret += "\\r"; break;
+		case '\t': ret += "\\t"; break;
+		default:
+			if (static_cast<unsigned char>(c) < 0x20) {
+				ret += std::format("\\u{:04x}", static_cast<unsigned>(c));
+			} else {
+				ret += c;
+			}
+			break;
+		}
+	}
+	return ret;
+}
+} // namespace
+
+void trace::set_enabled(bool const enabled) {
+	// ensure the epoch precedes every recorded event.
+	if (enabled) { Registry::self(); }
+	g_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+auto trace::is_enabled() -> bool {
+	return g_enabled.load(std::memory_order_relaxed);
+}
+
+void trace::set_thread_name(std::string name) {
+	this_thread_buffer().name = std::move(name);
+}
+
+void trace::record(char const* name, Clock::time_point const start,
+				   Clock::time_point const end) {
+	this_thread_buffer().events.push_back(
+		Event{.name = name, .start = start, .end = end});
+}
+
+auto trace::write_json(std::filesystem::path const& path) -> bool {
+	auto file = std::ofstream{path};
+	if (!file.is_open()) {
+		std::println(stderr, "[lvk] Failed to open '{}' for writing",
+					 path.generic_string());
+		return false;
+	}
+
+	auto& registry = Registry::self();
+	auto lock = std::scoped_lock{registry.mutex};
+	auto event_count = std::size_t{};
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	auto separator = std::string_view{"\n"};
+	for (auto const& buffer : registry.buffers) {
+		// metadata event: thread name.
+		file << separator
+			 << std::format("{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":"
+							"0,\"tid\":{},\"args\":{{\"name\":\"{}\"}}}}",
+							buffer->id, escape_json(buffer->name));
+		separator = ",\n";
+		for (auto const& event : buffer->events) {
+			// complete event: start timestamp and duration, in microseconds.
+			file << separator
+				 << std::format("{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":0,"
+								"\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+								escape_json(event.name), buffer->id,
+								to_us(event.start - registry.epoch),
+								to_us(event.end - event.start));
+		}
+		event_count += buffer->events.size();
+	}
+	file << "\n]}\n";
+
+	std::println("[lvk] {} trace events written to '{}'", event_count,
+				 path.generic_string());
+	return true;
+}
+} // namespace lvk
@@ -0,0 +1,48 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+// Low overhead CPU tracing: scoped zones are recorded into thread-local
+// buffers (no locks after a thread's first zone), and exported in the Chrome
+// trace event format (chrome://tracing, ui.perfetto.dev).
+namespace lvk::trace {
+using Clock = std::chrono::steady_clock;
+
+// zones are only recorded while tracing is enabled (disabled by default).
+void set_enabled(bool enabled);
+[[nodiscard]] auto is_enabled() -> bool;
+
+// name shown for the calling thread in the trace.
+void set_thread_name(std::string name);
+
+// records a completed zone on the calling thread.
+// name must be a string literal (or otherwise outlive the trace).
+void record(char const* name, Clock::time_point start, Clock::time_point end);
+
+// writes all recorded zones as Chrome trace JSON.
+// must not be called while other threads are recording.
+auto write_json(std::filesystem::path const& path) -> bool;
+
+// RAII zone: records [construction, destruction) on the calling thread.
+class Zone {
+  public:
+	Zone(Zone const&) = delete;
+	Zone(Zone&&) = delete;
+	auto operator=(Zone const&) = delete;
+	auto operator=(Zone&&) = delete;
+
+	explicit Zone(char const* name) : m_name(is_enabled() ? name : nullptr) {
+		if (m_name != nullptr) { m_start = Clock::now(); }
+	}
+
+	~Zone() {
+		if (m_name != nullptr) { record(m_name, m_start, Clock::now()); }
+	}
+
+  private:
+	char const* m_name{};
+	Clock::time_point m_start{};
+};
+} // namespace lvk::trace
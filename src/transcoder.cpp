@@ -0,0 +1,482 @@
+#include <transcoder.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iterator>
+#include <stdexcept>
+
+namespace lvk {
+namespace {
+constexpr auto block_dim_v = 4u;
+
+using Texel = std::array<std::int32_t, 4>; // RGBA, 0-255.
+// decoded 4x4 block, row-major.
+using Block = std::array<Texel, block_dim_v * block_dim_v>;
+
+struct FormatInfo {
+	std::uint32_t block_size{}; // bytes, 0 if not transcodable.
+	bool etc2{};				// BC1 otherwise.
+	// BC1: index 3 of 3-color blocks is transparent, ETC2: EAC alpha block.
+	bool alpha{};
+	std::span<vk::Format const> targets{};
+};
+
+constexpr auto unorm_targets_v = std::array{vk::Format::eR8G8B8A8Unorm};
+constexpr auto srgb_targets_v = std::array{vk::Format::eR8G8B8A8Srgb};
+constexpr auto opaque_unorm_targets_v =
+	std::array{vk::Format::eBc1RgbUnormBlock, vk::Format::eR8G8B8A8Unorm};
+constexpr auto opaque_srgb_targets_v =
+	std::array{vk::Format::eBc1RgbSrgbBlock, vk::Format::eR8G8B8A8Srgb};
+
+[[nodiscard]] auto get_info(vk::Format const format) -> FormatInfo {
+	using enum vk::Format;
+	switch (format) {
+	case eBc1RgbUnormBlock: return {8, false, false, unorm_targets_v};
+	case eBc1RgbSrgbBlock: return {8, false, false, srgb_targets_v};
+	case eBc1RgbaUnormBlock: return {8, false, true, unorm_targets_v};
+	case eBc1RgbaSrgbBlock: return {8, false, true, srgb_targets_v};
+	case eEtc2R8G8B8UnormBlock:
+		return {8, true, false, opaque_unorm_targets_v};
+	case eEtc2R8G8B8SrgbBlock: return {8, true, false, opaque_srgb_targets_v};
+	case eEtc2R8G8B8A8UnormBlock: return {16, true, true, unorm_targets_v};
+	case eEtc2R8G8B8A8SrgbBlock: return {16, true, true, srgb_targets_v};
+	default: return {};
+	}
+}
+
+[[nodiscard]] auto is_rgba8(vk::Format const format) -> bool {
+	return format == vk::Format::eR8G8B8A8Unorm ||
+		   format == vk::Format::eR8G8B8A8Srgb;
+}
+
+// ETC blocks are big endian, BC blocks little endian.
+[[nodiscard]] auto load_be64(std::byte const* src) -> std::uint64_t {
+	auto ret = std::uint64_t{};
+	for (auto i = 0uz; i < 8; ++i) {
+		ret = (ret << 8) | std::to_integer<std::uint64_t>(src[i]);
+	}
+	return ret;
+}
+
+[[nodiscard]] auto load_le(std::byte const* src, std::size_t const size)
+	-> std::uint32_t {
+	auto ret = std::uint32_t{};
+	for (auto i = size; i > 0; --i) {
+		ret = (ret << 8) | std::to_integer<std::uint32_t>(src[i - 1]);
+	}
+	return ret;
+}
+
+void store_le(std::byte* dst, std::uint32_t value, std::size_t const size) {
+	for (auto i = 0uz; i < size; ++i, value >>= 8) {
+		dst[i] = static_cast<std::byte>(value & 0xff);
+	}
+}
+
+// bits [low, high] of value.
+[[nodiscard]] auto bits(std::uint64_t const value, int const high,
+						int const low) -> std::int32_t {
+	auto const mask = (std::uint64_t{1} << (high - low + 1)) - 1;
+	return static_cast<std::int32_t>((value >> low) & mask);
+}
+
+[[nodiscard]] auto clamp_channel(std::int32_t const value) -> std::int32_t {
+	return std::clamp(value, 0, 255);
+}
+
+[[nodiscard]] auto extend(std::int32_t const value, int const width)
+	-> std::int32_t {
+	return (value << (8 - width)) | (value >> (2 * width - 8));
+}
+
+[[nodiscard]] auto extend_4(std::int32_t const value) -> std::int32_t {
+	return value * 17;
+}
+
+[[nodiscard]] auto unpack_565(std::uint32_t const color) -> Texel {
+	auto const c = static_cast<std::int32_t>(color);
+	return Texel{extend((c >> 11) & 0x1f, 5), extend((c >> 5) & 0x3f, 6),
+				 extend(c & 0x1f, 5), 255};
+}
+
+[[nodiscard]] auto pack_565(Texel const& texel) -> std::uint32_t {
+	auto const quantize = [](std::int32_t const value, std::int32_t max) {
+		return static_cast<std::uint32_t>((value * max + 127) / 255);
+	};
+	return (quantize(texel[0], 31) << 11) | (quantize(texel[1], 63) << 5) |
+		   quantize(texel[2], 31);
+}
+
+// BC1 palette of two 565 endpoints.
+[[nodiscard]] auto bc1_palette(std::uint32_t const c0, std::uint32_t const c1,
+							   bool const alpha) -> std::array<Texel, 4> {
+	auto ret = std::array<Texel, 4>{unpack_565(c0), unpack_565(c1)};
+	for (auto c = 0uz; c < 3; ++c) {
+		auto const a = ret[0][c];
+		auto const b = ret[1][c];
+		if (c0 > c1) {
+			ret[2][c] = (2 * a + b) / 3;
+			ret[3][c] = (a + 2 * b) / 3;
+		} else {
+			ret[2][c] = (a + b) / 2;
+		}
+	}
+	ret[2][3] = 255;
+	ret[3][3] = c0 > c1 || !alpha ? 255 : 0;
+	return ret;
+}
+
+void decode_bc1(std::byte const* src, bool const alpha, Block& out) {
+	auto const palette =
+		bc1_palette(load_le(src, 2), load_le(src + 2, 2), alpha);
+	auto const indices = load_le(src + 4, 4);
+	for (auto i = 0uz; i < out.size(); ++i) {
+		out.at(i) = palette.at((indices >> (2 * i)) & 3);
+	}
+}
+
+// ETC1 intensity modifiers, by table codeword and texel index.
+constexpr auto etc1_modifiers_v = std::array<std::array<std::int32_t, 4>, 8>{{
+	{2, 8, -2, -8},
+	{5, 17, -5, -17},
+	{9, 29, -9, -29},
+	{13, 42, -13, -42},
+	{18, 60, -18, -60},
+	{24, 80, -24, -80},
+	{33, 106, -33, -106},
+	{47, 183, -47, -183},
+}};
+
+// ETC2 T and H mode distances.
+constexpr auto etc2_distances_v =
+	std::array<std::int32_t, 8>{3, 6, 11, 16, 23, 32, 41, 64};
+
+// EAC alpha modifiers, by table index and texel index.
+constexpr auto eac_modifiers_v = std::array<std::array<std::int32_t, 8>, 16>{{
+	{-3, -6, -9, -15, 2, 5, 8, 14},
+	{-3, -7, -10, -13, 2, 6, 9, 12},
+	{-2, -5, -8, -13, 1, 4, 7, 12},
+	{-2, -4, -6, -13, 1, 3, 5, 12},
+	{-3, -6, -8, -12, 2, 5, 7, 11},
+	{-3, -7, -9, -11, 2, 6, 8, 10},
+	{-4, -7, -8, -11, 3, 6, 7, 10},
+	{-3, -5, -8, -11, 2, 4, 7, 10},
+	{-2, -6, -8, -10, 1, 5, 7, 9},
+	{-2, -5, -8, -10, 1, 4, 7, 9},
+	{-2, -4, -8, -10, 1, 3, 7, 9},
+	{-2, -5, -7, -10, 1, 4, 6, 9},
+	{-3, -4, -7, -10, 2, 3, 6, 9},
+	{-1, -2, -3, -10, 0, 1, 2, 9},
+	{-4, -6, -8, -9, 3, 5, 7, 8},
+	{-3, -5, -7, -9, 2, 4, 6, 8},
+}};
+
+[[nodiscard]] auto add(Texel const& texel, std::int32_t const value)
+	-> Texel {
+	return Texel{clamp_channel(texel[0] + value),
+				 clamp_channel(texel[1] + value),
+				 clamp_channel(texel[2] + value), 255};
+}
+
+// ETC2 RGB block: ETC1 individual / differential modes, and T, H, planar.
+void decode_etc2(std::byte const* src, Block& out) {
+	auto const block = load_be64(src);
+	// texels are indexed column by column, with split index bits.
+	auto const get_index = [block](std::uint32_t const x,
+								   std::uint32_t const y) {
+		auto const i = static_cast<int>(x * block_dim_v + y);
+		return static_cast<std::size_t>((bits(block, i + 16, i + 16) << 1) |
+										bits(block, i, i));
+	};
+	auto const for_each_texel = [&out](auto const& func) {
+		for (auto y = 0u; y < block_dim_v; ++y) {
+			for (auto x = 0u; x < block_dim_v; ++x) {
+				out.at(y * block_dim_v + x) = func(x, y);
+			}
+		}
+	};
+	auto const paint = [&](std::array<Texel, 4> const& colors) {
+		for_each_texel([&](std::uint32_t const x, std::uint32_t const y) {
+			return colors.at(get_index(x, y));
+		});
+	};
+
+	auto c1 = Texel{};
+	auto c2 = Texel{};
+	if (bits(block, 33, 33) == 0) {
+		// individual: two 4-bit colors.
+		c1 = {extend_4(bits(block, 63, 60)), extend_4(bits(block, 55, 52)),
+			  extend_4(bits(block, 47, 44)), 255};
+		c2 = {extend_4(bits(block, 59, 56)), extend_4(bits(block, 51, 48)),
+			  extend_4(bits(block, 43, 40)), 255};
+	} else {
+		// differential: 5-bit color and 3-bit signed deltas, overflows
+		// select the ETC2 modes.
+		auto const delta = [block](int const low) {
+			auto const d = bits(block, low + 2, low);
+			return d >= 4 ? d - 8 : d;
+		};
+		auto const r = bits(block, 63, 59);
+		auto const g = bits(block, 55, 51);
+		auto const b = bits(block, 47, 43);
+		auto const r2 = r + delta(56);
+		auto const g2 = g + delta(48);
+		auto const b2 = b + delta(40);
+		auto const overflows = [](std::int32_t const value) {
+			return value < 0 || value > 31;
+		};
+		if (overflows(r2)) {
+			// T mode.
+			c1 = {extend_4((bits(block, 60, 59) << 2) | bits(block, 57, 56)),
+				  extend_4(bits(block, 55, 52)), extend_4(bits(block, 51, 48)),
+				  255};
+			c2 = {extend_4(bits(block, 47, 44)), extend_4(bits(block, 43, 40)),
+				  extend_4(bits(block, 39, 36)), 255};
+			auto const d = etc2_distances_v.at(static_cast<std::size_t>(
+				(bits(block, 35, 34) << 1) | bits(block, 32, 32)));
+			paint({c1, add(c2, d), c2, add(c2, -d)});
+			return;
+		}
+		if (overflows(g2)) {
+			// H mode.
+			auto const r1 = bits(block, 62, 59);
+			auto const g1 = (bits(block, 58, 56) << 1) | bits(block, 52, 52);
+			auto const b1 = (bits(block, 51, 51) << 3) | bits(block, 49, 47);
+			auto const r3 = bits(block, 46, 43);
+			auto const g3 = bits(block, 42, 39);
+			auto const b3 = bits(block, 38, 35);
+			// the order of the colors is the lowest distance bit.
+			auto const order = ((r1 << 8) | (g1 << 4) | b1) >=
+							   ((r3 << 8) | (g3 << 4) | b3);
+			auto const d = etc2_distances_v.at(static_cast<std::size_t>(
+				(bits(block, 34, 34) << 2) | (bits(block, 32, 32) << 1) |
+				(order ? 1 : 0)));
+			c1 = {extend_4(r1), extend_4(g1), extend_4(b1), 255};
+			c2 = {extend_4(r3), extend_4(g3), extend_4(b3), 255};
+			paint({add(c1, d), add(c1, -d), add(c2, d), add(c2, -d)});
+			return;
+		}
+		if (overflows(b2)) {
+			// planar: origin, horizontal and vertical colors.
+			auto const o = Texel{
+				extend(bits(block, 62, 57), 6),
+				extend((bits(block, 56, 56) << 6) | bits(block, 54, 49), 7),
+				extend((bits(block, 48, 48) << 5) | (bits(block, 44, 43) << 3) |
+						   bits(block, 41, 39),
+					   6),
+			};
+			auto const h = Texel{
+				extend((bits(block, 38, 34) << 1) | bits(block, 32, 32), 6),
+				extend(bits(block, 31, 25), 7),
+				extend(bits(block, 24, 19), 6),
+			};
+			auto const v = Texel{
+				extend(bits(block, 18, 13), 6),
+				extend(bits(block, 12, 6), 7),
+				extend(bits(block, 5, 0), 6),
+			};
+			for_each_texel([&](std::uint32_t const x, std::uint32_t const y) {
+				auto ret = Texel{0, 0, 0, 255};
+				auto const ix = static_cast<std::int32_t>(x);
+				auto const iy = static_cast<std::int32_t>(y);
+				for (auto c = 0uz; c < 3; ++c) {
+					ret[c] = clamp_channel((ix * (h[c] - o[c]) +
+											iy * (v[c] - o[c]) + 4 * o[c] +
+											2) >>
+										   2);
+				}
+				return ret;
+			});
+			return;
+		}
+		c1 = {extend(r, 5), extend(g, 5), extend(b, 5), 255};
+		c2 = {extend(r2, 5), extend(g2, 5), extend(b2, 5), 255};
+	}
+
+	// two sub-blocks, side by side or (flipped) on top of each other.
+	auto const flip = bits(block, 32, 32) != 0;
+	auto const table_1 = etc1_modifiers_v.at(
+		static_cast<std::size_t>(bits(block, 39, 37)));
+	auto const table_2 = etc1_modifiers_v.at(
+		static_cast<std::size_t>(bits(block, 36, 34)));
+	for_each_texel([&](std::uint32_t const x, std::uint32_t const y) {
+		auto const second = flip ? y >= 2 : x >= 2;
+		auto const& table = second ? table_2 : table_1;
+		return add(second ? c2 : c1, table.at(get_index(x, y)));
+	});
+}
+
+void decode_eac_alpha(std::byte const* src, Block& out) {
+	auto const block = load_be64(src);
+	auto const base = bits(block, 63, 56);
+	auto const multiplier = bits(block, 55, 52);
+	auto const& table =
+		eac_modifiers_v.at(static_cast<std::size_t>(bits(block, 51, 48)));
+	for (auto y = 0u; y < block_dim_v; ++y) {
+		for (auto x = 0u; x < block_dim_v; ++x) {
+			// 3-bit indices, column by column.
+			auto const i = static_cast<int>(x * block_dim_v + y);
+			auto const index = bits(block, 47 - 3 * i, 45 - 3 * i);
+			auto const modifier = table.at(static_cast<std::size_t>(index));
+			out.at(y * block_dim_v + x)[3] =
+				clamp_channel(base + modifier * multiplier);
+		}
+	}
+}
+
+void decode(FormatInfo const& info, std::byte const* src, Block& out) {
+	if (!info.etc2) {
+		decode_bc1(src, info.alpha, out);
+		return;
+	}
+	if (!info.alpha) {
+		decode_etc2(src, out);
+		return;
+	}
+	decode_etc2(src + 8, out);
+	decode_eac_alpha(src, out);
+}
+
+// opaque BC1: endpoints are the extremes along the principal axis of the
+// colors, each texel picks the closest of the 4 palette entries.
+void encode_bc1(Block const& block, std::byte* dst) {
+	auto mean = std::array<float, 3>{};
+	for (auto const& texel : block) {
+		for (auto c = 0uz; c < 3; ++c) {
+			mean.at(c) += static_cast<float>(texel.at(c));
+		}
+	}
+	for (auto& m : mean) { m /= static_cast<float>(block.size()); }
+	// covariance: xx, xy, xz, yy, yz, zz.
+	auto cov = std::array<float, 6>{};
+	for (auto const& texel : block) {
+		auto const d = std::array{static_cast<float>(texel[0]) - mean[0],
+								  static_cast<float>(texel[1]) - mean[1],
+								  static_cast<float>(texel[2]) - mean[2]};
+		cov[0] += d[0] * d[0];
+		cov[1] += d[0] * d[1];
+		cov[2] += d[0] * d[2];
+		cov[3] += d[1] * d[1];
+		cov[4] += d[1] * d[2];
+		cov[5] += d[2] * d[2];
+	}
+	// power iteration.
+	auto axis = std::array{1.0f, 1.0f, 1.0f};
+	for (auto i = 0; i < 8; ++i) {
+		auto const next = std::array{
+			cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2],
+			cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2],
+			cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2],
+		};
+		auto const length = std::max(
+			{std::abs(next[0]), std::abs(next[1]), std::abs(next[2])});
+		if (length <= 0.0f) { break; }
+		for (auto c = 0uz; c < 3; ++c) { axis.at(c) = next.at(c) / length; }
+	}
+	auto const project = [&axis](Texel const& texel) {
+		return static_cast<float>(texel[0]) * axis[0] +
+			   static_cast<float>(texel[1]) * axis[1] +
+			   static_cast<float>(texel[2]) * axis[2];
+	};
+	auto const [min, max] = std::ranges::minmax_element(
+		block, [&](Texel const& a, Texel const& b) {
+			return project(a) < project(b);
+		});
+
+	auto c0 = pack_565(*max);
+	auto c1 = pack_565(*min);
+	if (c0 < c1) { std::swap(c0, c1); }
+	auto indices = std::uint32_t{};
+	if (c0 != c1) {
+		// 4-color mode (c0 > c1).
+		auto const palette = bc1_palette(c0, c1, false);
+		for (auto i = 0uz; i < block.size(); ++i) {
+			auto const distance = [&](Texel const& color) {
+				auto ret = 0;
+				for (auto c = 0uz; c < 3; ++c) {
+					auto const d = color.at(c) - block.at(i).at(c);
+					ret += d * d;
+				}
+				return ret;
+			};
+			auto const it = std::ranges::min_element(palette, {}, distance);
+			auto const index = std::distance(palette.begin(), it);
+			indices |= static_cast<std::uint32_t>(index) << (2 * i);
+		}
+	}
+	store_le(dst, c0, 2);
+	store_le(dst + 2, c1, 2);
+	store_le(dst + 4, indices, 4);
+}
+
+void write_texels(Block const& block, std::uint32_t const block_x,
+				  std::uint32_t const block_y, vk::Extent2D const extent,
+				  std::span<std::byte> dst) {
+	for (auto y = 0u; y < block_dim_v; ++y) {
+		auto const texel_y = block_y * block_dim_v + y;
+		if (texel_y >= extent.height) { break; }
+		for (auto x = 0u; x < block_dim_v; ++x) {
+			auto const texel_x = block_x * block_dim_v + x;
+			if (texel_x >= extent.width) { break; }
+			auto const& texel = block.at(y * block_dim_v + x);
+			auto const offset = std::size_t{texel_y} * extent.width + texel_x;
+			auto* out = dst.data() + offset * 4;
+			for (auto c = 0uz; c < 4; ++c) {
+				out[c] = static_cast<std::byte>(texel.at(c));
+			}
+		}
+	}
+}
+} // namespace
+
+auto can_transcode(vk::Format const format) -> bool {
+	return get_info(format).block_size > 0;
+}
+
+auto get_transcode_formats(vk::Format const format)
+	-> std::span<vk::Format const> {
+	return get_info(format).targets;
+}
+
+auto get_level_size(vk::Format const format, vk::Extent2D const extent)
+	-> vk::DeviceSize {
+	if (is_rgba8(format)) {
+		return vk::DeviceSize{extent.width} * extent.height * 4;
+	}
+	auto const blocks_x = (extent.width + block_dim_v - 1) / block_dim_v;
+	auto const blocks_y = (extent.height + block_dim_v - 1) / block_dim_v;
+	return vk::DeviceSize{blocks_x} * blocks_y * get_info(format).block_size;
+}
+
+void transcode_rows(vk::Format const format, vk::Format const target,
+					std::span<std::byte const> src, vk::Extent2D const extent,
+					std::span<std::byte> dst, std::uint32_t const first,
+					std::uint32_t last) {
+	auto const info = get_info(format);
+	if (std::ranges::find(info.targets, target) == info.targets.end()) {
+		throw std::invalid_argument{"Unsupported transcode formats"};
+	}
+	if (src.size() < get_level_size(format, extent) ||
+		dst.size() < get_level_size(target, extent)) {
+		throw std::invalid_argument{"Level is smaller than its extent"};
+	}
+	auto const blocks_x = (extent.width + block_dim_v - 1) / block_dim_v;
+	auto const blocks_y = (extent.height + block_dim_v - 1) / block_dim_v;
+	auto const encode = !is_rgba8(target);
+	// the size of BC1 blocks.
+	static constexpr auto encoded_size_v = 8uz;
+	last = std::min(last, blocks_y);
+	auto block = Block{};
+	for (auto y = first; y < last; ++y) {
+		for (auto x = 0u; x < blocks_x; ++x) {
+			auto const index = std::size_t{y} * blocks_x + x;
+			decode(info, src.data() + index * info.block_size, block);
+			if (encode) {
+				encode_bc1(block, dst.data() + index * encoded_size_v);
+			} else {
+				write_texels(block, x, y, extent, dst);
+			}
+		}
+	}
+}
+} // namespace lvk
@@ -0,0 +1,29 @@
+#pragma once
+#include <vulkan/vulkan.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace lvk {
+// CPU fallback for block compressed formats that the GPU cannot sample:
+// BC1 and ETC2 (with EAC alpha) 4x4 blocks are decoded, and re-encoded to
+// BC1 or expanded to RGBA8.
+
+// whether blocks of format can be transcoded.
+[[nodiscard]] auto can_transcode(vk::Format format) -> bool;
+// formats that format can be transcoded to, most compact first: BC1 for
+// opaque formats, RGBA8 as a last resort. Empty if it cannot be transcoded.
+[[nodiscard]] auto get_transcode_formats(vk::Format format)
+	-> std::span<vk::Format const>;
+// bytes of a level of format (transcodable or a transcode format).
+[[nodiscard]] auto get_level_size(vk::Format format, vk::Extent2D extent)
+	-> vk::DeviceSize;
+
+// transcodes rows [first, last) of 4x4 blocks of a level of format from src
+// into target (one of its transcode formats). src and dst cover the whole
+// level, so rows can be transcoded concurrently.
+void transcode_rows(vk::Format format, vk::Format target,
+					std::span<std::byte const> src, vk::Extent2D extent,
+					std::span<std::byte> dst, std::uint32_t first,
+					std::uint32_t last);
+} // namespace lvk
@@ -0,0 +1,332 @@
+#include <transform_batch.hpp>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+	(defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LVK_TRANSFORM_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define LVK_TRANSFORM_NEON
+#endif
+
+namespace lvk {
+namespace {
+// Model matrix of a 2D transform (T * R * S), column-major:
+// | c*sx  -s*sy  0  px |
+// | s*sx   c*sy  0  py |
+// | 0      0     1  0  |
+// | 0      0     0  1  |
+// Only the 2x2 block and translation vary, sin/cos are evaluated with a
+// polynomial approximation so that every lane takes the same path.
+
+constexpr auto deg_to_rad_v = std::numbers::pi_v<float> / 180.0f;
+constexpr auto two_over_pi_v = 2.0f / std::numbers::pi_v<float>;
+// pi/2 split into a high and a low part for accurate range reduction.
+constexpr auto half_pi_hi_v = 1.5703125f;
+constexpr auto half_pi_lo_v = 4.837512969970703125e-4f;
+constexpr auto half_pi_lo2_v = 7.54978995489188216e-8f;
+// minimax coefficients over [-pi/4, pi/4].
+constexpr auto sin_c0_v = -1.6666654611e-1f;
+constexpr auto sin_c1_v = 8.3321608736e-3f;
+constexpr auto sin_c2_v = -1.9515295891e-4f;
+constexpr auto cos_c0_v = 4.166664568298827e-2f;
+constexpr auto cos_c1_v = -1.388731625493765e-3f;
+constexpr auto cos_c2_v = 2.443315711809948e-5f;
+
+struct SinCos {
+	float sin{};
+	float cos{};
+};
+
+[[nodiscard]] auto sin_cos(float const degrees) -> SinCos {
+	auto const x = degrees * deg_to_rad_v;
+	auto const j = std::nearbyint(x * two_over_pi_v);
+	auto const quadrant = static_cast<std::int32_t>(j);
+	auto const r =
+		((x - j * half_pi_hi_v) - j * half_pi_lo_v) - j * half_pi_lo2_v;
+	auto const r2 = r * r;
+	auto const s = r + r * r2 * (sin_c0_v + r2 * (sin_c1_v + r2 * sin_c2_v));
+	auto const c = 1.0f - 0.5f * r2 +
+				   r2 * r2 * (cos_c0_v + r2 * (cos_c1_v + r2 * cos_c2_v));
+	auto ret = (quadrant & 1) == 0 ? SinCos{s, c} : SinCos{c, s};
+	if ((quadrant & 2) != 0) { ret.sin = -ret.sin; }
+	if (((quadrant + 1) & 2) != 0) { ret.cos = -ret.cos; }
+	return ret;
+}
+
+void write_scalar(float const px, float const py, float const rotation,
+				  float const sx, float const sy, float* out) {
+	auto const [s, c] = sin_cos(rotation);
+	float const matrix[] = {
+		c * sx, s * sx, 0.0f, 0.0f, -s * sy, c * sy, 0.0f, 0.0f,
+		0.0f,	0.0f,	1.0f, 0.0f, px,		 py,	 0.0f, 1.0f,
+	};
+	for (auto const value : matrix) { *out++ = value; }
+}
+
+#if defined(LVK_TRANSFORM_SSE2)
+constexpr std::size_t lanes_v{4};
+
+[[nodiscard]] auto polynomial(__m128 const r, __m128 const r2, float const c0,
+							  float const c1, float const c2) -> __m128 {
+	auto ret = _mm_add_ps(_mm_set1_ps(c1), _mm_mul_ps(r2, _mm_set1_ps(c2)));
+	ret = _mm_add_ps(_mm_set1_ps(c0), _mm_mul_ps(r2, ret));
+	return _mm_mul_ps(r, ret);
+}
+
+void sin_cos(__m128 const degrees, __m128& out_sin, __m128& out_cos) {
+	auto const x = _mm_mul_ps(degrees, _mm_set1_ps(deg_to_rad_v));
+	// round to nearest (default rounding mode).
+	auto const quadrant =
+		_mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(two_over_pi_v)));
+	auto const j = _mm_cvtepi32_ps(quadrant);
+	auto r = _mm_sub_ps(x, _mm_mul_ps(j, _mm_set1_ps(half_pi_hi_v)));
+	r = _mm_sub_ps(r, _mm_mul_ps(j, _mm_set1_ps(half_pi_lo_v)));
+	r = _mm_sub_ps(r, _mm_mul_ps(j, _mm_set1_ps(half_pi_lo2_v)));
+	auto const r2 = _mm_mul_ps(r, r);
+
+	auto const s = _mm_add_ps(
+		r, polynomial(_mm_mul_ps(r, r2), r2, sin_c0_v, sin_c1_v, sin_c2_v));
+	auto c = polynomial(_mm_mul_ps(r2, r2), r2, cos_c0_v, cos_c1_v, cos_c2_v);
+	c = _mm_add_ps(_mm_sub_ps(_mm_set1_ps(1.0f),
+							  _mm_mul_ps(_mm_set1_ps(0.5f), r2)),
+				   c);
+
+	// odd quadrants swap sin and cos.
+	auto const one = _mm_set1_epi32(1);
+	auto const swap = _mm_castsi128_ps(
+		_mm_cmpeq_epi32(_mm_and_si128(quadrant, one), one));
+	auto const sin = _mm_or_ps(_mm_and_ps(swap, c), _mm_andnot_ps(swap, s));
+	auto const cos = _mm_or_ps(_mm_and_ps(swap, s), _mm_andnot_ps(swap, c));
+	// flip signs: sin in quadrants 2 and 3, cos in quadrants 1 and 2.
+	auto const two = _mm_set1_epi32(2);
+	auto const sin_sign = _mm_slli_epi32(_mm_and_si128(quadrant, two), 30);
+	auto const cos_sign = _mm_slli_epi32(
+		_mm_and_si128(_mm_add_epi32(quadrant, one), two), 30);
+	out_sin = _mm_xor_ps(sin, _mm_castsi128_ps(sin_sign));
+	out_cos = _mm_xor_ps(cos, _mm_castsi128_ps(cos_sign));
+}
+
+void write_lanes(float const* px, float const* py, float const* rotation,
+				 float const* sx, float const* sy, float* out) {
+	auto s = __m128{};
+	auto c = __m128{};
+	sin_cos(_mm_loadu_ps(rotation), s, c);
+	auto const scale_x = _mm_loadu_ps(sx);
+	auto const scale_y = _mm_loadu_ps(sy);
+	auto m00 = _mm_mul_ps(c, scale_x);
+	auto m01 = _mm_mul_ps(s, scale_x);
+	auto m10 = _mm_sub_ps(_mm_setzero_ps(), _mm_mul_ps(s, scale_y));
+	auto m11 = _mm_mul_ps(c, scale_y);
+	// transpose: lane i => (m00, m01, m10, m11) of instance i.
+	_MM_TRANSPOSE4_PS(m00, m01, m10, m11);
+	auto const rows = std::array{m00, m01, m10, m11};
+
+	auto const zero = _mm_setzero_ps();
+	auto const z_axis = _mm_set_ps(0.0f, 1.0f, 0.0f, 0.0f);
+	auto const zw = _mm_set_ps(1.0f, 0.0f, 1.0f, 0.0f);
+	auto const position_x = _mm_loadu_ps(px);
+	auto const position_y = _mm_loadu_ps(py);
+	auto const xy01 = _mm_unpacklo_ps(position_x, position_y);
+	auto const xy23 = _mm_unpackhi_ps(position_x, position_y);
+	auto const translations = std::array{
+		_mm_movelh_ps(xy01, zw),
+		_mm_movehl_ps(zw, xy01),
+		_mm_movelh_ps(xy23, zw),
+		_mm_movehl_ps(zw, xy23),
+	};
+
+	for (std::size_t i = 0; i < lanes_v; ++i, out += 16) {
+		_mm_storeu_ps(out, _mm_movelh_ps(rows.at(i), zero));
+		_mm_storeu_ps(out + 4, _mm_movehl_ps(zero, rows.at(i)));
+		_mm_storeu_ps(out + 8, z_axis);
+		_mm_storeu_ps(out + 12, translations.at(i));
+	}
+}
+#elif defined(LVK_TRANSFORM_NEON)
+constexpr std::size_t lanes_v{4};
+
+[[nodiscard]] auto polynomial(float32x4_t const r, float32x4_t const r2,
+							  float const c0, float const c1, float const c2)
+	-> float32x4_t {
+	auto ret = vmlaq_n_f32(vdupq_n_f32(c1), r2, c2);
+	ret = vmlaq_f32(vdupq_n_f32(c0), r2, ret);
+	return vmulq_f32(r, ret);
+}
+
+void sin_cos(float32x4_t const degrees, float32x4_t& out_sin,
+			 float32x4_t& out_cos) {
+	auto const x = vmulq_n_f32(degrees, deg_to_rad_v);
+	auto const quadrant = vcvtnq_s32_f32(vmulq_n_f32(x, two_over_pi_v));
+	auto const j = vcvtq_f32_s32(quadrant);
+	auto r = vmlsq_n_f32(x, j, half_pi_hi_v);
+	r = vmlsq_n_f32(r, j, half_pi_lo_v);
+	r = vmlsq_n_f32(r, j, half_pi_lo2_v);
+	auto const r2 = vmulq_f32(r, r);
+
+	auto const s = vaddq_f32(
+		r, polynomial(vmulq_f32(r, r2), r2, sin_c0_v, sin_c1_v, sin_c2_v));
+	auto c = polynomial(vmulq_f32(r2, r2), r2, cos_c0_v, cos_c1_v, cos_c2_v);
+	c = vaddq_f32(vmlsq_n_f32(vdupq_n_f32(1.0f), r2, 0.5f), c);
+
+	// odd quadrants swap sin and cos.
+	auto const one = vdupq_n_s32(1);
+	auto const swap = vceqq_s32(vandq_s32(quadrant, one), one);
+	auto const sin = vbslq_f32(swap, c, s);
+	auto const cos = vbslq_f32(swap, s, c);
+	// flip signs: sin in quadrants 2 and 3, cos in quadrants 1 and 2.
+	auto const two = vdupq_n_s32(2);
+	auto const sin_sign =
+		vreinterpretq_u32_s32(vshlq_n_s32(vandq_s32(quadrant, two), 30));
+	auto const cos_sign = vreinterpretq_u32_s32(
+		vshlq_n_s32(vandq_s32(vaddq_s32(quadrant, one), two), 30));
+	out_sin = vreinterpretq_f32_u32(
+		veorq_u32(vreinterpretq_u32_f32(sin), sin_sign));
+	out_cos = vreinterpretq_f32_u32(
+		veorq_u32(vreinterpretq_u32_f32(cos), cos_sign));
+}
+
+void write_lanes(float const* px, float const* py, float const* rotation,
+				 float const* sx, float const* sy, float* out) {
+	auto s = float32x4_t{};
+	auto c = float32x4_t{};
+	sin_cos(vld1q_f32(rotation), s, c);
+	auto const scale_x = vld1q_f32(sx);
+	auto const scale_y = vld1q_f32(sy);
+	auto const m00 = vmulq_f32(c, scale_x);
+	auto const m01 = vmulq_f32(s, scale_x);
+	auto const m10 = vnegq_f32(vmulq_f32(s, scale_y));
+	auto const m11 = vmulq_f32(c, scale_y);
+	// transpose: lane i => (m00, m01, m10, m11) of instance i.
+	auto const t0 = vzipq_f32(m00, m10);
+	auto const t1 = vzipq_f32(m01, m11);
+	auto const r01 = vzipq_f32(t0.val[0], t1.val[0]);
+	auto const r23 = vzipq_f32(t0.val[1], t1.val[1]);
+	auto const rows =
+		std::array{r01.val[0], r01.val[1], r23.val[0], r23.val[1]};
+
+	auto const zero = vdup_n_f32(0.0f);
+	auto const zw = float32x2_t{0.0f, 1.0f};
+	auto const z_axis = vcombine_f32(zero, float32x2_t{1.0f, 0.0f});
+	auto const xy = vzipq_f32(vld1q_f32(px), vld1q_f32(py));
+	auto const translations = std::array{
+		vcombine_f32(vget_low_f32(xy.val[0]), zw),
+		vcombine_f32(vget_high_f32(xy.val[0]), zw),
+		vcombine_f32(vget_low_f32(xy.val[1]), zw),
+		vcombine_f32(vget_high_f32(xy.val[1]), zw),
+	};
+
+	for (std::size_t i = 0; i < lanes_v; ++i, out += 16) {
+		vst1q_f32(out, vcombine_f32(vget_low_f32(rows.at(i)), zero));
+		vst1q_f32(out + 4, vcombine_f32(vget_high_f32(rows.at(i)), zero));
+		vst1q_f32(out + 8, z_axis);
+		vst1q_f32(out + 12, translations.at(i));
+	}
+}
+#else
+constexpr std::size_t lanes_v{1};
+
+void write_lanes(float const* px, float const* py, float const* rotation,
+				 float const* sx, float const* sy, float* out) {
+	write_scalar(*px, *py, *rotation, *sx, *sy, out);
+}
+#endif
+} // namespace
+
+void TransformBatch::resize(std::size_t const count) {
+	m_position_x.resize(count);
+	m_position_y.resize(count);
+	m_rotation.resize(count);
+	// new transforms have unit scale, like Transform.
+	m_scale_x.resize(count, 1.0f);
+	m_scale_y.resize(count, 1.0f);
+	m_color.resize(count, PackedInstance{}.color);
+	m_texture.resize(count);
+	// buffers may have been reallocated: everything needs uploading.
+	m_dirty.assign((count + word_bits_v - 1) / word_bits_v, ~Word{});
+	if (auto const tail = count % word_bits_v; tail != 0) {
+		m_dirty.back() = (Word{1} << tail) - 1;
+	}
+}
+
+auto TransformBatch::get(std::size_t const index) const -> Transform {
+	return Transform{
+		.position = {m_position_x.at(index), m_position_y.at(index)},
+		.rotation = m_rotation.at(index),
+		.scale = {m_scale_x.at(index), m_scale_y.at(index)},
+	};
+}
+
+void TransformBatch::set(std::size_t const index, Transform const& transform) {
+	m_position_x.at(index) = transform.position.x;
+	m_position_y.at(index) = transform.position.y;
+	m_rotation.at(index) = transform.rotation;
+	m_scale_x.at(index) = transform.scale.x;
+	m_scale_y.at(index) = transform.scale.y;
+	mark_dirty(index);
+}
+
+void TransformBatch::take_dirty_ranges(std::vector<Range>& out) {
+	auto const first_new = out.size();
+	for (std::size_t w = 0; w < m_dirty.size(); ++w) {
+		auto word = std::exchange(m_dirty[w], Word{});
+		while (word != 0) {
+			// run of set bits starting at the lowest one.
+			auto const begin = static_cast<std::size_t>(std::countr_zero(word));
+			auto const length =
+				static_cast<std::size_t>(std::countr_one(word >> begin));
+			auto const first = w * word_bits_v + begin;
+			// coalesce with a run ending at the previous word's boundary.
+			if (out.size() > first_new &&
+				out.back().first + out.back().count == first) {
+				out.back().count += length;
+			} else {
+				out.push_back(Range{.first = first, .count = length});
+			}
+			if (begin + length == word_bits_v) { break; }
+			word &= ~(((Word{1} << length) - 1) << begin);
+		}
+	}
+}
+
+void TransformBatch::write_model_matrices(std::size_t const first,
+										  std::span<glm::mat4> out) const {
+	assert(first + out.size() <= size());
+	// glm::mat4 is 16 contiguous floats, column-major.
+	void* data = out.data();
+	auto* dst = static_cast<float*>(data);
+	auto i = first;
+	auto const end = first + out.size();
+	for (; i + lanes_v <= end; i += lanes_v, dst += 16 * lanes_v) {
+		write_lanes(&m_position_x[i], &m_position_y[i], &m_rotation[i],
+					&m_scale_x[i], &m_scale_y[i], dst);
+	}
+	for (; i < end; ++i, dst += 16) {
+		write_scalar(m_position_x[i], m_position_y[i], m_rotation[i],
+					 m_scale_x[i], m_scale_y[i], dst);
+	}
+}
+
+void TransformBatch::write_packed_instances(
+	std::size_t const first, std::span<PackedInstance> out) const {
+	assert(first + out.size() <= size());
+	// no math: a straight (vectorizable) gather from the arrays.
+	for (std::size_t i = 0; i < out.size(); ++i) {
+		auto const index = first + i;
+		out[i] = PackedInstance{
+			.position = {m_position_x[index], m_position_y[index]},
+			.scale = {m_scale_x[index], m_scale_y[index]},
+			.rotation = m_rotation[index],
+			.color = m_color[index],
+			.texture = m_texture[index],
+		};
+	}
+}
+} // namespace lvk
@@ -0,0 +1,91 @@
+#pragma once
+#include <glm/mat4x4.hpp>
+#include <transform.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace lvk {
+// Compact per-instance data, expanded to a model matrix in the vertex shader
+// (glsl/shader_packed.vert). 32 bytes instead of 64 for a mat4.
+struct PackedInstance {
+	glm::vec2 position{};
+	glm::vec2 scale{1.0f};
+	float rotation{}; // degrees.
+	std::uint32_t color{0xffffffff}; // RGBA8, R in the lowest byte.
+	std::uint32_t texture{}; // bindless texture table slot.
+	std::uint32_t reserved{}; // std430 array stride is a multiple of 8.
+};
+static_assert(sizeof(PackedInstance) == 32);
+
+// Structure-of-arrays storage for many 2D transforms, laid out for batched
+// (SIMD) evaluation of model matrices.
+// Tracks which transforms changed since dirty ranges were last taken.
+class TransformBatch {
+  public:
+	// contiguous run of instances.
+	struct Range {
+		std::size_t first{};
+		std::size_t count{};
+	};
+
+	[[nodiscard]] auto size() const -> std::size_t { return m_rotation.size(); }
+
+	// marks every instance dirty.
+	void resize(std::size_t count);
+
+	[[nodiscard]] auto get(std::size_t index) const -> Transform;
+	void set(std::size_t index, Transform const& transform);
+
+	// RGBA8 tint, R in the lowest byte. Only used by packed instances.
+	[[nodiscard]] auto get_color(std::size_t index) const -> std::uint32_t {
+		return m_color.at(index);
+	}
+	void set_color(std::size_t index, std::uint32_t color) {
+		m_color.at(index) = color;
+		mark_dirty(index);
+	}
+
+	// bindless texture table slot. Only used by packed instances.
+	[[nodiscard]] auto get_texture(std::size_t index) const -> std::uint32_t {
+		return m_texture.at(index);
+	}
+	void set_texture(std::size_t index, std::uint32_t texture) {
+		m_texture.at(index) = texture;
+		mark_dirty(index);
+	}
+
+	// appends ranges of instances modified since the last call to out,
+	// coalesced and in ascending order, and clears them. Cost is
+	// proportional to size() / 64 plus the number of dirty instances.
+	void take_dirty_ranges(std::vector<Range>& out);
+
+	// writes model matrices of transforms [first, first + out.size()) to out,
+	// which may be (write-combined) mapped GPU memory: it is only written to,
+	// sequentially.
+	void write_model_matrices(std::size_t first,
+							  std::span<glm::mat4> out) const;
+	// writes packed instances [first, first + out.size()) to out, with the
+	// same access pattern as write_model_matrices().
+	void write_packed_instances(std::size_t first,
+								std::span<PackedInstance> out) const;
+
+  private:
+	using Word = std::uint64_t;
+	static constexpr std::size_t word_bits_v{64};
+
+	void mark_dirty(std::size_t const index) {
+		m_dirty[index / word_bits_v] |= Word{1} << (index % word_bits_v);
+	}
+
+	std::vector<float> m_position_x{};
+	std::vector<float> m_position_y{};
+	std::vector<float> m_rotation{}; // degrees.
+	std::vector<float> m_scale_x{};
+	std::vector<float> m_scale_y{};
+	std::vector<std::uint32_t> m_color{};
+	std::vector<std::uint32_t> m_texture{};
+	std::vector<Word> m_dirty{}; // one bit per instance.
+};
+} // namespace lvk
@@ -1,4 +1,5 @@
 #include <vma.hpp>
+#include <mip_chain.hpp>
 #include <numeric>
 #include <print>
 #include <stdexcept>
@@ -21,7 +22,8 @@ void ImageDeleter::operator()(RawImage const& raw_image) const noexcept {
 
 auto vma::create_allocator(vk::Instance const instance,
 						   vk::PhysicalDevice const physical_device,
-						   vk::Device const device) -> Allocator {
+						   vk::Device const device,
+						   bool const buffer_device_address) -> Allocator {
 	auto const& dispatcher = VULKAN_HPP_DEFAULT_DISPATCHER;
 	// need to zero initialize C structs, unlike VulkanHPP.
 	auto vma_vk_funcs = VmaVulkanFunctions{};
@@ -33,6 +35,9 @@ auto vma::create_allocator(vk::Instance const instance,
 	allocator_ci.device = device;
 	allocator_ci.pVulkanFunctions = &vma_vk_funcs;
 	allocator_ci.instance = instance;
+	if (buffer_device_address) {
+		allocator_ci.flags |= VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT;
+	}
 	VmaAllocator ret{};
 	auto const result = vmaCreateAllocator(&allocator_ci, &ret);
 	if (result == VK_SUCCESS) { return ret; }
@@ -40,6 +45,13 @@ auto vma::create_allocator(vk::Instance const instance,
 	throw std::runtime_error{"Failed to create Vulkan Memory Allocator"};
 }
 
+auto vma::get_physical_device(VmaAllocator const allocator)
+	-> vk::PhysicalDevice {
+	auto info = VmaAllocatorInfo{};
+	vmaGetAllocatorInfo(allocator, &info);
+	return info.physicalDevice;
+}
+
 auto vma::create_buffer(BufferCreateInfo const& create_info,
 						BufferMemoryType const memory_type,
 						vk::DeviceSize const size) -> Buffer {
@@ -179,15 +191,28 @@ auto vma::create_image(ImageCreateInfo const& create_info,
 auto vma::create_sampled_image(ImageCreateInfo const& create_info,
 							   CommandBlock command_block, Bitmap const& bitmap)
 	-> Image {
-	// create image.
-	// no mip-mapping right now: 1 level.
-	auto const mip_levels = 1u;
+	// create image with a full mip chain.
+	auto const format = vk::Format::eR8G8B8A8Srgb;
 	auto const usize = glm::uvec2{bitmap.size};
 	auto const extent = vk::Extent2D{usize.x, usize.y};
-	auto const usage =
-		vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled;
-	auto ret = create_image(create_info, usage, mip_levels,
-							vk::Format::eR8G8B8A8Srgb, extent);
+	auto const mip_levels = get_mip_levels(extent);
+	auto const usage = vk::ImageUsageFlagBits::eTransferSrc |
+					   vk::ImageUsageFlagBits::eTransferDst |
+					   vk::ImageUsageFlagBits::eSampled;
+	auto ret = create_image(create_info, usage, mip_levels, format, extent);
+
+	// levels are blitted from level 0 if the format supports it, box
+	// filtered on the CPU otherwise.
+	auto const blit =
+		can_blit_mips(get_physical_device(create_info.allocator), format);
+	auto chain = MipChain{};
+	if (blit) {
+		chain.offsets = {0};
+	} else {
+		chain = build_mip_chain(bitmap, mip_levels);
+	}
+	auto const bytes =
+		blit ? bitmap.bytes : std::span<std::byte const>{chain.bytes};
 
 	// create staging buffer.
 	auto const buffer_ci = BufferCreateInfo{
@@ -196,14 +221,13 @@ auto vma::create_sampled_image(ImageCreateInfo const& create_info,
 		.queue_family = create_info.queue_family,
 	};
 	auto const staging_buffer = create_buffer(buffer_ci, BufferMemoryType::Host,
-											  bitmap.bytes.size_bytes());
+											  bytes.size_bytes());
 
 	// can't do anything if either creation failed.
 	if (!ret.get().image || !staging_buffer.get().buffer) { return {}; }
 
 	// copy bytes into staging buffer.
-	std::memcpy(staging_buffer.get().mapped, bitmap.bytes.data(),
-				bitmap.bytes.size_bytes());
+	std::memcpy(staging_buffer.get().mapped, bytes.data(), bytes.size_bytes());
 
 	// transition image for transfer.
 	auto dependency_info = vk::DependencyInfo{};
@@ -226,23 +250,37 @@ auto vma::create_sampled_image(ImageCreateInfo const& create_info,
 	dependency_info.setImageMemoryBarriers(barrier);
 	command_block.command_buffer().pipelineBarrier2(dependency_info);
 
-	// record buffer image copy.
-	auto buffer_image_copy = vk::BufferImageCopy2{};
-	auto subresource_layers = vk::ImageSubresourceLayers{};
-	subresource_layers.setAspectMask(vk::ImageAspectFlagBits::eColor)
-		.setLayerCount(1)
-		.setLayerCount(mip_levels);
-	buffer_image_copy.setImageSubresource(subresource_layers)
-		.setImageExtent(vk::Extent3D{extent.width, extent.height, 1});
+	// record buffer image copies, one per staged level.
+	auto buffer_image_copies = std::vector<vk::BufferImageCopy2>{};
+	for (auto level = 0u; level < chain.offsets.size(); ++level) {
+		auto const level_extent = get_mip_extent(extent, level);
+		auto subresource_layers = vk::ImageSubresourceLayers{};
+		subresource_layers.setAspectMask(vk::ImageAspectFlagBits::eColor)
+			.setMipLevel(level)
+			.setLayerCount(1);
+		auto& buffer_image_copy = buffer_image_copies.emplace_back();
+		buffer_image_copy.setBufferOffset(chain.offsets.at(level))
+			.setImageSubresource(subresource_layers)
+			.setImageExtent(
+				vk::Extent3D{level_extent.width, level_extent.height, 1});
+	}
 	auto copy_info = vk::CopyBufferToImageInfo2{};
 	copy_info.setDstImage(ret.get().image)
 		.setDstImageLayout(vk::ImageLayout::eTransferDstOptimal)
 		.setSrcBuffer(staging_buffer.get().buffer)
-		.setRegions(buffer_image_copy);
+		.setRegions(buffer_image_copies);
 	command_block.command_buffer().copyBufferToImage2(copy_info);
 
+	// generate the remaining levels.
+	auto layout = vk::ImageLayout::eTransferDstOptimal;
+	if (blit) {
+		record_mip_blits(command_block.command_buffer(), ret.get().image,
+						 extent, 1, mip_levels);
+		layout = vk::ImageLayout::eTransferSrcOptimal;
+	}
+
 	// transition image for sampling.
-	barrier.setOldLayout(barrier.newLayout)
+	barrier.setOldLayout(layout)
 		.setNewLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
 		.setSrcStageMask(barrier.dstStageMask)
 		.setSrcAccessMask(barrier.dstAccessMask)
@@ -252,6 +290,7 @@ auto vma::create_sampled_image(ImageCreateInfo const& create_info,
 	dependency_info.setImageMemoryBarriers(barrier);
 	command_block.command_buffer().pipelineBarrier2(dependency_info);
 
+	// submit and wait: keeps the staging buffer alive while the GPU reads it.
 	command_block.submit_and_wait();
 
 	return ret;
@@ -12,9 +12,16 @@ struct Deleter {
 
 using Allocator = Scoped<VmaAllocator, Deleter>;
 
+// buffer_device_address: the feature is enabled on device, allocations
+// support buffers with ShaderDeviceAddress usage.
 [[nodiscard]] auto create_allocator(vk::Instance instance,
 									vk::PhysicalDevice physical_device,
-									vk::Device device) -> Allocator;
+									vk::Device device,
+									bool buffer_device_address = false)
+	-> Allocator;
+
+[[nodiscard]] auto get_physical_device(VmaAllocator allocator)
+	-> vk::PhysicalDevice;
 
 struct RawBuffer {
 	[[nodiscard]] auto mapped_span() const -> std::span<std::byte> {
@@ -52,6 +59,7 @@ enum class BufferMemoryType : std::int8_t { Host, Device };
 using ByteSpans = std::span<std::span<std::byte const> const>;
 
 // returns a Device Buffer with each byte span sequentially written.
+// blocks until the upload completes: StagingRing batches uploads instead.
 [[nodiscard]] auto create_device_buffer(BufferCreateInfo const& create_info,
 										CommandBlock command_block,
 										ByteSpans const& byte_spans) -> Buffer;
@@ -83,6 +91,7 @@ struct ImageCreateInfo {
 								vk::Format format, vk::Extent2D extent)
 	-> Image;
 
+// blocks until the upload completes: StagingRing batches uploads instead.
 [[nodiscard]] auto create_sampled_image(ImageCreateInfo const& create_info,
 										CommandBlock command_block,
 										Bitmap const& bitmap) -> Image;